@@ -0,0 +1,412 @@
+// Benchmark suite timing every ABS and GPV operation over ring sizes,
+// attribute counts and thread counts. The results are written as JSON with
+// percentiles, and two result files can be compared to flag regressions.
+//
+// Usage: abs-benchmark [--backends NativePoly,Poly,DCRTPoly] [--rings 512,1024]
+//                      [--attributes 1,3,6] [--threads 1,N] [--repetitions 20]
+//                      [--slow-repetitions 3] [--batch 32] [--output file]
+//                      [--stats file]
+//        abs-benchmark --compare baseline.json current.json [--threshold 10]
+//
+// The compare mode exits with status 1 when the median of any benchmark got
+// slower than the baseline by more than the threshold, in percent. The
+// --stats file gets the per phase timings accumulated over the whole run.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "absparallel.h"
+#include "absstats.h"
+#include "utils/parallel.h"
+
+using namespace lbcrypto;
+
+typedef std::chrono::steady_clock Clock;
+
+struct BenchmarkOptions {
+  vector<string> backends = {"NativePoly"};
+  vector<usint> rings = {512, 1024};
+  vector<usint> attributes = {1, 3, 6};
+  vector<usint> threads;
+  usint repetitions = 20;
+  usint slowRepetitions = 3;
+  usint batch = 32;
+  string output;
+  string stats;
+};
+
+struct BenchmarkResult {
+  string name;
+  string backend;
+  usint ringsize;
+  usint attributes;
+  usint threads;
+  vector<double> samples;
+};
+
+// Value at the given fraction of the sorted samples (nearest rank)
+static double percentile(const vector<double> &sorted, double fraction) {
+  size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+  return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+// Times repetitions runs of an operation, in milliseconds per item
+static vector<double> measure(usint repetitions, usint items, const std::function<void()> &operation) {
+  vector<double> samples;
+  for (usint r = 0; r < repetitions; r++) {
+    auto start = Clock::now();
+    operation();
+    samples.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count() / items);
+  }
+  return samples;
+}
+
+static string resultKey(const string &name, const string &backend, usint ringsize, usint attributes, usint threads) {
+  return name + "/" + backend + "/" + std::to_string(ringsize) + "/" + std::to_string(attributes) + "/" +
+         std::to_string(threads);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//                                  Running                                  //
+///////////////////////////////////////////////////////////////////////////////
+
+template <class Element>
+static void runBackend(const string &backend, const BenchmarkOptions &options, vector<BenchmarkResult> *results) {
+  string message = "This is a text";
+  GPVPlaintext<Element> plaintext(message);
+
+  auto record = [&](const string &name, usint ringsize, usint attributes, usint threads, vector<double> samples) {
+    double total = 0;
+    for (double sample : samples) total += sample;
+
+    std::cerr << std::setw(18) << name << std::setw(12) << backend << std::setw(6) << ringsize << std::setw(4)
+              << attributes << std::setw(4) << threads << std::setw(12) << std::fixed << std::setprecision(3)
+              << total / samples.size() << " ms" << std::endl;
+    results->push_back(BenchmarkResult{name, backend, ringsize, attributes, threads, std::move(samples)});
+  };
+
+  for (usint ringsize : options.rings) {
+    SignatureContext<Element> context;
+    record("context", ringsize, 0, 1,
+           measure(options.slowRepetitions, 1, [&] { context.GenerateGPVContext(ringsize); }));
+
+    GPVVerificationKey<Element> vk;
+    GPVSignKey<Element> sk;
+    record("setup", ringsize, 0, 1, measure(options.slowRepetitions, 1, [&] { context.Setup(&sk, &vk); }));
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(context.GetParams());
+    auto zero_alloc = Element::Allocator(params->GetILParams(), EVALUATION);
+
+    // Base GPV scheme
+    GPVSignature<Element> gpvSignature;
+    record("gpv-sign", ringsize, 0, 1,
+           measure(options.repetitions, 1, [&] { context.Sign(plaintext, sk, vk, &gpvSignature); }));
+
+    vector<PerturbationVector<Element>> perturbations(options.repetitions);
+    for (auto &pv : perturbations) context.SignOfflinePhase(sk, pv);
+    usint next = 0;
+    record("gpv-sign-online", ringsize, 0, 1, measure(options.repetitions, 1, [&] {
+             context.SignOnlinePhase(plaintext, sk, vk, perturbations[next++], &gpvSignature);
+           }));
+
+    record("gpv-verify", ringsize, 0, 1,
+           measure(options.repetitions, 1, [&] { context.Verify(plaintext, gpvSignature, vk); }));
+
+    for (usint count : options.attributes) {
+      vector<string> attributes;
+      for (usint i = 0; i < count; i++) {
+        attributes.push_back(attributesList[i % 6] + (i < 6 ? "" : "#" + std::to_string(i)));
+      }
+
+      // No caches, so every run hashes the attributes again
+      Matrix<Element> syndromeMatrix(zero_alloc, 1, 32);
+      record("attribute-hash", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               attributeHashGenerator(attributes, params, &syndromeMatrix);
+             }));
+
+      vector<shared_ptr<Matrix<Element>>> key;
+      for (usint threads : options.threads) {
+        record("extract", ringsize, count, threads, measure(options.slowRepetitions, 1, [&] {
+                 key = extract<Element>(params, sk, vk, attributes, nullptr, threads);
+               }));
+      }
+
+      signatureABS<Element> signature = sign(params, key, vk, message, attributes);
+      record("sign", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               signature = sign(params, key, vk, message, attributes);
+             }));
+      record("verify", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               verify(params, vk, message, signature);
+             }));
+
+      // Same calls with reused scratch space and output signature
+      SignWorkspace<Element> signWorkspace;
+      VerifyWorkspace<Element> verifyWorkspace;
+      record("sign-workspace", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               MemoryMessageSource source(message);
+               sign(params, key, vk, source, attributes, &signWorkspace, &signature);
+             }));
+      record("verify-workspace", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               MemoryMessageSource source(message);
+               verify(params, vk, source, signature, &verifyWorkspace);
+             }));
+
+      // Same calls with the syndromes read from an attribute registry
+      AttributeRegistry<Element> registry(params, attributes);
+      vector<AttributeId> ids = registry.getIds(attributes);
+      Element syndromes(params->GetILParams(), EVALUATION, true);
+      record("registry-syndrome", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               registry.accumulate(ids, signature.getSignatureHash(), &syndromes);
+             }));
+      record("sign-registry", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               MemoryMessageSource source(message);
+               signature = sign(params, key, vk, source, registry, ids);
+             }));
+      record("verify-registry", ringsize, count, 1, measure(options.repetitions, 1, [&] {
+               MemoryMessageSource source(message);
+               verify<Element>(params, vk, source, signature, registry, nullptr, &verifyWorkspace);
+             }));
+
+      // Single calls split among the intra-operation workers
+      for (usint threads : options.threads) {
+        if (threads == 1) continue;
+        ABSIntraOpScope intraOp(threads);
+        record("sign-intra", ringsize, count, threads, measure(options.repetitions, 1, [&] {
+                 MemoryMessageSource source(message);
+                 sign(params, key, vk, source, attributes, &signWorkspace, &signature);
+               }));
+        record("verify-intra", ringsize, count, threads, measure(options.repetitions, 1, [&] {
+                 MemoryMessageSource source(message);
+                 verify(params, vk, source, signature, &verifyWorkspace);
+               }));
+      }
+
+      vector<string> messages(options.batch, message);
+      vector<std::pair<signatureABS<Element>, string>> batch(options.batch, std::make_pair(signature, message));
+      for (usint threads : options.threads) {
+        record("sign-batch", ringsize, count, threads, measure(options.repetitions, options.batch, [&] {
+                 signBatch(params, key, vk, messages, attributes, TAG_ENCODING_BINARY, threads);
+               }));
+        record("verify-batch", ringsize, count, threads, measure(options.repetitions, options.batch, [&] {
+                 verifyBatch<Element>(params, vk, batch, nullptr, threads);
+               }));
+      }
+    }
+  }
+}
+
+static void writeJson(std::ostream &out, const BenchmarkOptions &options, const vector<BenchmarkResult> &results) {
+  out << "{" << std::endl
+      << "  \"suite\": \"abs-benchmark\"," << std::endl
+      << "  \"machine_threads\": " << PalisadeParallelControls.GetMachineThreads() << "," << std::endl
+      << "  \"repetitions\": " << options.repetitions << "," << std::endl
+      << "  \"benchmarks\": [" << std::endl;
+
+  // One benchmark per line, which is what the compare mode reads back
+  out << std::fixed << std::setprecision(6);
+  for (size_t i = 0; i < results.size(); i++) {
+    const BenchmarkResult &result = results[i];
+    vector<double> sorted(result.samples);
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0;
+    for (double sample : sorted) mean += sample / sorted.size();
+
+    out << "    {\"name\": \"" << result.name << "\", \"backend\": \"" << result.backend
+        << "\", \"ringsize\": " << result.ringsize << ", \"attributes\": " << result.attributes
+        << ", \"threads\": " << result.threads << ", \"samples\": " << sorted.size()
+        << ", \"mean_ms\": " << mean << ", \"min_ms\": " << sorted.front()
+        << ", \"p50_ms\": " << percentile(sorted, 0.5) << ", \"p90_ms\": " << percentile(sorted, 0.9)
+        << ", \"p99_ms\": " << percentile(sorted, 0.99) << ", \"max_ms\": " << sorted.back() << "}"
+        << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+
+  out << "  ]" << std::endl << "}" << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//                                 Comparing                                 //
+///////////////////////////////////////////////////////////////////////////////
+
+// Raw text of a field of a single line JSON object, without quotes
+static string jsonField(const string &line, const string &field) {
+  string pattern = "\"" + field + "\": ";
+  size_t start = line.find(pattern);
+  if (start == string::npos) return "";
+
+  start += pattern.size();
+  if (line[start] == '"') {
+    return line.substr(start + 1, line.find('"', start + 1) - start - 1);
+  }
+  return line.substr(start, line.find_first_of(",}", start) - start);
+}
+
+// Median times of a result file, by benchmark key
+static std::map<string, double> readMedians(const string &path) {
+  std::ifstream in(path);
+  if (!in) {
+    std::cerr << "Cannot read " << path << std::endl;
+    std::exit(2);
+  }
+
+  std::map<string, double> medians;
+  string line;
+  while (std::getline(in, line)) {
+    if (jsonField(line, "name").empty()) continue;
+    string key = resultKey(jsonField(line, "name"), jsonField(line, "backend"),
+                           std::atoi(jsonField(line, "ringsize").c_str()),
+                           std::atoi(jsonField(line, "attributes").c_str()),
+                           std::atoi(jsonField(line, "threads").c_str()));
+    medians[key] = std::atof(jsonField(line, "p50_ms").c_str());
+  }
+  return medians;
+}
+
+static int compare(const string &baselinePath, const string &currentPath, double threshold) {
+  std::map<string, double> baseline = readMedians(baselinePath);
+  std::map<string, double> current = readMedians(currentPath);
+  int regressions = 0;
+
+  std::cout << std::left << std::setw(44) << "benchmark" << std::right << std::setw(14) << "base p50 ms"
+            << std::setw(14) << "p50 ms" << std::setw(10) << "change" << std::endl;
+
+  for (const auto &entry : current) {
+    auto base = baseline.find(entry.first);
+    if (base == baseline.end()) {
+      std::cout << std::left << std::setw(44) << entry.first << std::right << std::setw(14) << "-"
+                << std::setw(14) << std::fixed << std::setprecision(3) << entry.second << "       new" << std::endl;
+      continue;
+    }
+
+    double change = 100.0 * (entry.second - base->second) / base->second;
+    bool regression = change > threshold;
+    regressions += regression;
+
+    std::cout << std::left << std::setw(44) << entry.first << std::right << std::setw(14) << std::fixed
+              << std::setprecision(3) << base->second << std::setw(14) << entry.second << std::setw(9)
+              << std::setprecision(1) << change << "%" << (regression ? "  REGRESSION" : "") << std::endl;
+  }
+
+  for (const auto &entry : baseline) {
+    if (current.find(entry.first) == current.end()) {
+      std::cout << std::left << std::setw(44) << entry.first << std::right << "       missing" << std::endl;
+    }
+  }
+
+  std::cout << std::endl << regressions << " regression(s) above " << threshold << "%" << std::endl;
+  return regressions > 0 ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//                                   Main                                    //
+///////////////////////////////////////////////////////////////////////////////
+
+static vector<string> splitList(const string &list) {
+  vector<string> items;
+  std::stringstream stream(list);
+  string item;
+  while (std::getline(stream, item, ',')) items.push_back(item);
+  return items;
+}
+
+static vector<usint> splitNumbers(const string &list) {
+  vector<usint> numbers;
+  for (const string &item : splitList(list)) numbers.push_back(std::atoi(item.c_str()));
+  return numbers;
+}
+
+int main(int argc, char *argv[]) {
+  BenchmarkOptions options;
+  usint machineThreads = PalisadeParallelControls.GetMachineThreads();
+  options.threads = {1};
+  if (machineThreads > 1) options.threads.push_back(machineThreads);
+
+  double threshold = 10;
+  vector<string> compareFiles;
+
+  for (int i = 1; i < argc; i++) {
+    string option = argv[i];
+    if (option == "--compare" && i + 2 < argc) {
+      compareFiles = {argv[i + 1], argv[i + 2]};
+      i += 2;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << option << std::endl;
+      return 2;
+    }
+
+    string value = argv[++i];
+    if (option == "--backends") {
+      options.backends = splitList(value);
+    } else if (option == "--rings") {
+      options.rings = splitNumbers(value);
+    } else if (option == "--attributes") {
+      options.attributes = splitNumbers(value);
+    } else if (option == "--threads") {
+      options.threads = splitNumbers(value);
+    } else if (option == "--repetitions") {
+      options.repetitions = std::atoi(value.c_str());
+    } else if (option == "--slow-repetitions") {
+      options.slowRepetitions = std::atoi(value.c_str());
+    } else if (option == "--batch") {
+      options.batch = std::atoi(value.c_str());
+    } else if (option == "--output") {
+      options.output = value;
+    } else if (option == "--stats") {
+      options.stats = value;
+    } else if (option == "--threshold") {
+      threshold = std::atof(value.c_str());
+    } else {
+      std::cerr << "Unknown option " << option << std::endl;
+      return 2;
+    }
+  }
+
+  if (!compareFiles.empty()) {
+    return compare(compareFiles[0], compareFiles[1], threshold);
+  }
+
+  if (options.repetitions == 0 || options.slowRepetitions == 0 || options.batch == 0 ||
+      options.threads.empty()) {
+    std::cerr << "Repetitions, batch size and thread counts must be given" << std::endl;
+    return 2;
+  }
+
+  // Progress goes to stderr, so the JSON can be redirected from stdout
+  vector<BenchmarkResult> results;
+  for (const string &backend : options.backends) {
+    if (backend == "Poly") {
+      runBackend<Poly>(backend, options, &results);
+    } else if (backend == "NativePoly") {
+      runBackend<NativePoly>(backend, options, &results);
+    } else if (backend == "DCRTPoly") {
+      runBackend<DCRTPoly>(backend, options, &results);
+    } else {
+      std::cerr << "Unknown backend " << backend << std::endl;
+      return 2;
+    }
+  }
+
+  if (options.output.empty()) {
+    writeJson(std::cout, options, results);
+  } else {
+    std::ofstream out(options.output);
+    writeJson(out, options, results);
+  }
+
+  if (!options.stats.empty()) {
+    std::ofstream out(options.stats);
+    out << absStatsJson(absStatsSnapshot()) << std::endl;
+  }
+
+  return 0;
+}
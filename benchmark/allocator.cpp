@@ -0,0 +1,176 @@
+// Benchmark of the ring element allocations with malloc and with the slab
+// allocator. Each allocator runs in its own child process, so the resident
+// memory of one run is not counted in the other. A run times the allocation
+// and release of ring elements from every thread, then signs and verifies
+// from every thread with a shared context, and reports the resident and peak
+// resident memory at the end. Every signature is checked, so the run also
+// fails if the allocator hands out a block twice.
+//
+// Usage: allocator-benchmark [threads] [signatures per thread] [--huge-pages]
+
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "absslab.h"
+#include "utils/parallel.h"
+
+using namespace lbcrypto;
+
+// Elements allocated and released per thread by the allocation test
+static const usint ELEMENTS_PER_THREAD = 100000;
+
+// Runs work(t) on each of the given number of threads and returns the
+// elapsed seconds
+template <class Work>
+static double runThreads(usint threads, Work work) {
+  vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (usint t = 0; t < threads; t++) {
+    workers.emplace_back(work, t);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// One run with the given allocator, printing a row of the table. Returns the
+// number of signatures that did not verify, or -1 if the slab allocator
+// could not be enabled
+template <class Element>
+static int runAllocator(const char *backend, usint ringsize, bool slab, bool hugePages, usint threads,
+                        usint perThread) {
+  SignatureContext<Element> context;
+  context.GenerateGPVContext(ringsize);
+
+  if (slab) {
+    ABSSlabConfig config;
+    config.hugePages = hugePages;
+    if (!context.EnableSlabAllocator(config)) return -1;
+  }
+
+  GPVVerificationKey<Element> vk;
+  GPVSignKey<Element> sk;
+  context.Setup(&sk, &vk);
+  vector<string> attributes(std::begin(attributesList), std::end(attributesList));
+  vector<shared_ptr<Matrix<Element>>> ak = context.Extract(sk, vk, attributes);
+
+  // Allocation and release only, the elements are zeroed as the ABS code
+  // allocates them
+  auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(context.GetParams());
+  shared_ptr<typename Element::Params> ilParams = params->GetILParams();
+  double allocSeconds = runThreads(threads, [&](usint) {
+    for (usint i = 0; i < ELEMENTS_PER_THREAD; i++) {
+      Element element(ilParams, EVALUATION, true);
+    }
+  });
+
+  vector<vector<signatureABS<Element>>> signatures(threads);
+  std::atomic<usint> invalid(0);
+
+  double signSeconds = runThreads(threads, [&](usint t) {
+    signatures[t].reserve(perThread);
+    for (usint i = 0; i < perThread; i++) {
+      string message = "thread " + std::to_string(t) + " message " + std::to_string(i);
+      signatures[t].push_back(context.Sign(vk, ak, attributes, message));
+    }
+  });
+
+  // Each thread verifies the signatures of the next one, so the blocks are
+  // released by other threads than the ones that allocated them
+  double verifySeconds = runThreads(threads, [&](usint t) {
+    usint owner = (t + 1) % threads;
+    for (usint i = 0; i < perThread; i++) {
+      string message = "thread " + std::to_string(owner) + " message " + std::to_string(i);
+      if (!context.Verify(vk, signatures[owner][i], message)) invalid++;
+    }
+    signatures[owner].clear();
+  });
+
+  double elementNs = allocSeconds * 1e9 / ELEMENTS_PER_THREAD;
+  ABSSlabStats stats = absSlabStats();
+  const char *pages = !slab ? "-" :
+                      stats.pages == ABS_SLAB_PAGES_HUGETLB ? "hugetlb" :
+                      stats.pages == ABS_SLAB_PAGES_TRANSPARENT_HUGE ? "thp" : "4k";
+
+  std::cout << std::setw(10) << backend << std::setw(10) << ringsize
+            << std::setw(8) << (slab ? "slab" : "malloc") << std::setw(9) << pages
+            << std::setw(9) << threads
+            << std::setw(12) << std::fixed << std::setprecision(1) << elementNs
+            << std::setw(12) << threads * perThread / signSeconds
+            << std::setw(12) << threads * perThread / verifySeconds
+            << std::setw(10) << absResidentBytes() / double(1 << 20)
+            << std::setw(10) << absPeakResidentBytes() / double(1 << 20)
+            << std::endl;
+
+  return invalid;
+}
+
+// Runs one allocator in a child process and returns its exit status
+template <class Element>
+static int runChild(const char *backend, usint ringsize, bool slab, bool hugePages, usint threads,
+                    usint perThread) {
+  std::cout.flush();
+
+  pid_t child = fork();
+  if (child < 0) {
+    std::cerr << "fork failed: " << std::strerror(errno) << std::endl;
+    return 1;
+  }
+  if (child == 0) {
+    int invalid = runAllocator<Element>(backend, ringsize, slab, hugePages, threads, perThread);
+    if (invalid < 0) std::cerr << "The slab allocator could not be enabled" << std::endl;
+    if (invalid > 0) std::cerr << invalid << " signatures did not verify" << std::endl;
+    std::cout.flush();
+    _exit(invalid == 0 ? 0 : 1);
+  }
+
+  int status = 0;
+  waitpid(child, &status, 0);
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+int main(int argc, char *argv[]) {
+  usint threads = PalisadeParallelControls.GetMachineThreads();
+  usint perThread = 50;
+  bool hugePages = false;
+
+  int positional = 0;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--huge-pages") == 0) {
+      hugePages = true;
+    } else if (positional++ == 0) {
+      threads = std::atoi(argv[i]);
+    } else {
+      perThread = std::atoi(argv[i]);
+    }
+  }
+  if (threads == 0) threads = 1;
+
+  std::cout << std::setw(10) << "backend" << std::setw(10) << "ringsize"
+            << std::setw(8) << "alloc" << std::setw(9) << "pages" << std::setw(9) << "threads"
+            << std::setw(12) << "element ns" << std::setw(12) << "signs/s" << std::setw(12) << "verifies/s"
+            << std::setw(10) << "RSS MiB" << std::setw(10) << "peak MiB" << std::endl;
+
+  int failed = 0;
+  for (usint ringsize : {512, 1024}) {
+    for (bool slab : {false, true}) {
+      failed |= runChild<NativePoly>("NativePoly", ringsize, slab, hugePages, threads, perThread);
+    }
+    for (bool slab : {false, true}) {
+      failed |= runChild<DCRTPoly>("DCRTPoly", ringsize, slab, hugePages, threads, perThread);
+    }
+  }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,145 @@
+// Benchmark comparing the multiprecision (Poly), native 64-bit (NativePoly)
+// and RNS (DCRTPoly) backends on every ABS operation.
+//
+// Usage: backend-benchmark [repetitions]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "signaturecontext.h"
+#include "abs.h"
+
+using namespace lbcrypto;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void printRow(const string &backend, usint ringsize, usint bits, const string &operation, double ms) {
+  std::cout << std::setw(12) << backend << std::setw(10) << ringsize
+            << std::setw(6) << (bits ? std::to_string(bits) : string("-"))
+            << std::setw(12) << operation << std::setw(14) << std::fixed
+            << std::setprecision(3) << ms << std::endl;
+}
+
+// Runs every operation with the given backend and prints the mean times. A
+// bits of 0 uses the default modulus of the ring size
+template <class Element>
+static void runBackend(const string &backend, usint ringsize, usint bits, usint base, usint repetitions) {
+  vector<string> attributes(std::begin(attributesList), std::end(attributesList));
+  string message = "This is a text";
+
+  SignatureContext<Element> context;
+  auto start = Clock::now();
+  if (bits) {
+    context.GenerateGPVContext(ringsize, bits, base);
+  } else {
+    context.GenerateGPVContext(ringsize);
+  }
+  printRow(backend, ringsize, bits, "context", elapsedMs(start));
+
+  GPVVerificationKey<Element> vk;
+  GPVSignKey<Element> sk;
+  start = Clock::now();
+  context.Setup(&sk, &vk);
+  printRow(backend, ringsize, bits, "setup", elapsedMs(start));
+
+  // Extraction is the slowest operation, so it is run only once
+  start = Clock::now();
+  vector<shared_ptr<Matrix<Element>>> key = context.Extract(sk, vk, attributes);
+  printRow(backend, ringsize, bits, "extract", elapsedMs(start));
+
+  vector<signatureABS<Element>> signatures;
+  start = Clock::now();
+  for (usint r = 0; r < repetitions; r++) {
+    signatures.push_back(context.Sign(vk, key, attributes, message));
+  }
+  printRow(backend, ringsize, bits, "sign", elapsedMs(start) / repetitions);
+
+  bool valid = true;
+  start = Clock::now();
+  for (usint r = 0; r < repetitions; r++) {
+    valid &= context.Verify(vk, signatures[r], message);
+  }
+  printRow(backend, ringsize, bits, "verify", elapsedMs(start) / repetitions);
+
+  // Same checks with the key laid out for the A*z product, when it fits
+  if (context.PrepareVerificationKey(vk)) {
+    start = Clock::now();
+    for (usint r = 0; r < repetitions; r++) {
+      valid &= context.Verify(vk, signatures[r], message);
+    }
+    printRow(backend, ringsize, bits, "verify-prep", elapsedMs(start) / repetitions);
+  }
+
+  // Online signing with the nonces made in background. The pool is filled
+  // before timing and not refilled while timing, so only the message
+  // dependent part is measured
+  PrecomputePoolConfig config;
+  config.lowWatermark = 0;
+  config.highWatermark = repetitions;
+  context.EnableSigningPool(vk, config);
+  while (context.GetSigningPool()->GetStats().size < repetitions) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  start = Clock::now();
+  for (usint r = 0; r < repetitions; r++) {
+    signatures[r] = context.Sign(vk, key, attributes, message);
+  }
+  printRow(backend, ringsize, bits, "sign-online", elapsedMs(start) / repetitions);
+  context.DisableSigningPool();
+
+  for (usint r = 0; r < repetitions; r++) {
+    valid &= context.Verify(vk, signatures[r], message);
+  }
+
+  // Keys and syndromes added through 4 bit window subset sums. The first
+  // call of each builds the table, which is timed separately
+  context.SetSubsetSumWindow(4);
+  start = Clock::now();
+  signatures[0] = context.Sign(vk, key, attributes, message);
+  valid &= context.Verify(vk, signatures[0], message);
+  printRow(backend, ringsize, bits, "table-build", elapsedMs(start));
+
+  start = Clock::now();
+  for (usint r = 0; r < repetitions; r++) {
+    signatures[r] = context.Sign(vk, key, attributes, message);
+  }
+  printRow(backend, ringsize, bits, "sign-table", elapsedMs(start) / repetitions);
+
+  start = Clock::now();
+  for (usint r = 0; r < repetitions; r++) {
+    valid &= context.Verify(vk, signatures[r], message);
+  }
+  printRow(backend, ringsize, bits, "verify-table", elapsedMs(start) / repetitions);
+
+  if (!valid) {
+    std::cerr << backend << ": a signature failed to verify" << std::endl;
+  }
+}
+
+int main(int argc, char *argv[]) {
+  usint repetitions = 20;
+  if (argc > 1) repetitions = std::atoi(argv[1]);
+
+  std::cout << std::setw(12) << "backend" << std::setw(10) << "ringsize"
+            << std::setw(6) << "bits"
+            << std::setw(12) << "operation" << std::setw(14) << "ms" << std::endl;
+
+  for (usint ringsize : {512, 1024}) {
+    runBackend<Poly>("Poly", ringsize, 0, 0, repetitions);
+    runBackend<NativePoly>("NativePoly", ringsize, 0, 0, repetitions);
+    runBackend<DCRTPoly>("DCRTPoly", ringsize, 0, 0, repetitions);
+  }
+
+  // Moduli above 64 bits: multiprecision against two RNS towers
+  runBackend<Poly>("Poly", 1024, 100, 64, repetitions);
+  runBackend<DCRTPoly>("DCRTPoly", 1024, 100, 64, repetitions);
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+// Benchmark for a single SignatureContext shared by many threads, measuring
+// how the sign and verify throughput scale with the number of callers. Every
+// signature made concurrently is checked, so the run also fails if sharing
+// the context breaks any of them.
+//
+// Usage: concurrent-benchmark [max threads] [signatures per thread]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "utils/parallel.h"
+
+using namespace lbcrypto;
+
+// Thread count after the given one: powers of two, then the full core count
+// once, even if it is not a power of two. Past maxThreads when done
+static usint nextThreadCount(usint threads, usint maxThreads) {
+  usint next = threads * 2;
+  if (threads < maxThreads && next > maxThreads) next = maxThreads;
+  return next;
+}
+
+// Runs work(t) on each of the given number of threads and returns the
+// elapsed seconds
+template <class Work>
+static double runThreads(usint threads, Work work) {
+  vector<std::thread> workers;
+  auto start = std::chrono::steady_clock::now();
+  for (usint t = 0; t < threads; t++) {
+    workers.emplace_back(work, t);
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  usint maxThreads = PalisadeParallelControls.GetMachineThreads();
+  usint perThread = 50;
+
+  if (argc > 1) maxThreads = std::atoi(argv[1]);
+  if (argc > 2) perThread = std::atoi(argv[2]);
+
+  vector<string> attributes(std::begin(attributesList), std::end(attributesList));
+
+  std::cout << std::setw(10) << "ringsize" << std::setw(10) << "threads"
+            << std::setw(12) << "signs/s" << std::setw(10) << "speedup"
+            << std::setw(12) << "verifies/s" << std::setw(10) << "speedup"
+            << std::endl;
+
+  bool failed = false;
+  for (usint ringsize : {512, 1024}) {
+    SignatureContext<NativePoly> context;
+    context.GenerateGPVContext(ringsize);
+
+    GPVVerificationKey<NativePoly> vk;
+    GPVSignKey<NativePoly> sk;
+    context.Setup(&sk, &vk);
+    vector<shared_ptr<Matrix<NativePoly>>> ak = context.Extract(sk, vk, attributes);
+
+    // Warm up the caches so only the signing and verification are measured
+    context.Verify(vk, context.Sign(vk, ak, attributes, "warm up"), "warm up");
+
+    double signBaseline = 0;
+    double verifyBaseline = 0;
+    for (usint threads = 1; threads <= maxThreads; threads = nextThreadCount(threads, maxThreads)) {
+      vector<vector<signatureABS<NativePoly>>> signatures(threads);
+      std::atomic<usint> invalid(0);
+
+      double signSeconds = runThreads(threads, [&](usint t) {
+        signatures[t].reserve(perThread);
+        for (usint i = 0; i < perThread; i++) {
+          string message = "thread " + std::to_string(t) + " message " + std::to_string(i);
+          signatures[t].push_back(context.Sign(vk, ak, attributes, message));
+        }
+      });
+
+      double verifySeconds = runThreads(threads, [&](usint t) {
+        for (usint i = 0; i < perThread; i++) {
+          string message = "thread " + std::to_string(t) + " message " + std::to_string(i);
+          if (!context.Verify(vk, signatures[t][i], message)) invalid++;
+        }
+      });
+
+      double signRate = threads * perThread / signSeconds;
+      double verifyRate = threads * perThread / verifySeconds;
+      if (threads == 1) {
+        signBaseline = signRate;
+        verifyBaseline = verifyRate;
+      }
+
+      std::cout << std::setw(10) << ringsize << std::setw(10) << threads
+                << std::setw(12) << std::fixed << std::setprecision(1) << signRate
+                << std::setw(10) << std::setprecision(2) << signRate / signBaseline
+                << std::setw(12) << std::setprecision(1) << verifyRate
+                << std::setw(10) << std::setprecision(2) << verifyRate / verifyBaseline
+                << std::endl;
+
+      if (invalid > 0) {
+        std::cerr << invalid << " signatures made with " << threads << " threads did not verify" << std::endl;
+        failed = true;
+      }
+    }
+  }
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,68 @@
+// Benchmark for the attribute key extraction, measuring how the preimage
+// sampling of Extract scales with the number of workers.
+//
+// Usage: extract-benchmark [max threads] [repetitions]
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "utils/parallel.h"
+
+using namespace lbcrypto;
+
+// Thread count after the given one: powers of two, then the full core count
+// once, even if it is not a power of two. Past maxThreads when done
+static usint nextThreadCount(usint threads, usint maxThreads) {
+  usint next = threads * 2;
+  if (threads < maxThreads && next > maxThreads) next = maxThreads;
+  return next;
+}
+
+int main(int argc, char *argv[]) {
+  usint maxThreads = PalisadeParallelControls.GetMachineThreads();
+  usint repetitions = 3;
+
+  if (argc > 1) maxThreads = std::atoi(argv[1]);
+  if (argc > 2) repetitions = std::atoi(argv[2]);
+
+  vector<string> attributes(std::begin(attributesList), std::end(attributesList));
+
+  std::cout << std::setw(10) << "ringsize" << std::setw(10) << "threads"
+            << std::setw(14) << "ms/extract" << std::setw(10) << "speedup"
+            << std::endl;
+
+  for (usint ringsize : {512, 1024}) {
+    SignatureContext<Poly> context;
+    context.GenerateGPVContext(ringsize);
+
+    GPVVerificationKey<Poly> vk;
+    GPVSignKey<Poly> sk;
+    context.Setup(&sk, &vk);
+
+    // Warm up the syndrome cache so only the sampling is measured
+    context.Extract(sk, vk, attributes);
+
+    double baseline = 0;
+    for (usint threads = 1; threads <= maxThreads; threads = nextThreadCount(threads, maxThreads)) {
+      context.SetExtractThreads(threads);
+
+      auto start = std::chrono::steady_clock::now();
+      for (usint r = 0; r < repetitions; r++) {
+        context.Extract(sk, vk, attributes);
+      }
+      auto end = std::chrono::steady_clock::now();
+
+      double ms = std::chrono::duration<double, std::milli>(end - start).count() / repetitions;
+      if (threads == 1) baseline = ms;
+
+      std::cout << std::setw(10) << ringsize << std::setw(10) << threads
+                << std::setw(14) << std::fixed << std::setprecision(2) << ms
+                << std::setw(10) << baseline / ms << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+// Benchmark comparing the verifier startup from scratch (prime search, NTT
+// tables and trapdoor generation) with the startup from a key store.
+//
+// Usage: keystore-benchmark [store path]
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "keystore.h"
+
+using namespace lbcrypto;
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main(int argc, char *argv[]) {
+  string path = "abs-keystore.bin";
+  if (argc > 1) path = argv[1];
+
+  vector<string> attributes(std::begin(attributesList), std::end(attributesList));
+  string message = "This is a text";
+
+  std::cout << std::setw(10) << "ringsize" << std::setw(16) << "generate ms"
+            << std::setw(16) << "load ms" << std::setw(10) << "valid" << std::endl;
+
+  for (usint ringsize : {512, 1024}) {
+    auto start = Clock::now();
+    SignatureContext<NativePoly> context;
+    context.GenerateGPVContext(ringsize);
+    GPVVerificationKey<NativePoly> vk;
+    GPVSignKey<NativePoly> sk;
+    context.Setup(&sk, &vk);
+    double generateMs = elapsedMs(start);
+
+    context.SaveKeyStore(path, vk, &sk);
+    vector<shared_ptr<Matrix<NativePoly>>> key = context.Extract(sk, vk, attributes);
+    signatureABS<NativePoly> signature = context.Sign(vk, key, attributes, message);
+
+    // A verifier only needs the parameters and the verification key
+    start = Clock::now();
+    KeyStore<NativePoly> store(path);
+    SignatureContext<NativePoly> verifier;
+    verifier.GenerateGPVContext(store);
+    GPVVerificationKey<NativePoly> storedVk;
+    store.LoadVerificationKey(&storedVk);
+    double loadMs = elapsedMs(start);
+
+    bool valid = verifier.Verify(storedVk, signature, message);
+
+    std::cout << std::setw(10) << ringsize << std::setw(16) << std::fixed
+              << std::setprecision(3) << generateMs << std::setw(16) << loadMs
+              << std::setw(10) << valid << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,113 @@
+// Benchmark of the coefficient kernels at every SIMD level the CPU supports.
+// Before timing, the output of each level is compared word by word with the
+// scalar one; the program exits with an error if any of them differs.
+//
+// Usage: simd-benchmark [iterations]
+
+#include <stdlib.h>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "simdkernels.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct KernelInput {
+  std::vector<uint64_t> a, b, x, shoup;
+  uint64_t q;
+};
+
+static KernelInput randomInput(size_t n, uint64_t q, std::mt19937_64 *rng) {
+  KernelInput input;
+  input.q = q;
+  std::uniform_int_distribution<uint64_t> coefficient(0, q - 1);
+  for (size_t i = 0; i < n; i++) {
+    input.a.push_back(coefficient(*rng));
+    input.b.push_back(coefficient(*rng));
+    input.x.push_back(coefficient(*rng));
+    input.shoup.push_back(static_cast<uint64_t>(((unsigned __int128)input.b[i] << 64) / q));
+  }
+  return input;
+}
+
+// Runs the three kernels on a copy of the input, chaining their outputs so a
+// difference in any of them shows up in the result
+static std::vector<uint64_t> runKernels(const KernelInput &input) {
+  std::vector<uint64_t> sum(input.a);
+  size_t n = sum.size();
+
+  vectorModAdd(sum.data(), input.b.data(), n, input.q);
+  vectorModSub(sum.data(), input.x.data(), n, input.q);
+  for (int i = 0; i < 4; i++) {
+    vectorShoupMulAcc(sum.data(), input.x.data(), input.b.data(), input.shoup.data(), n, input.q);
+  }
+  return sum;
+}
+
+static double timeKernel(int iterations, const std::function<void()> &kernel) {
+  auto start = Clock::now();
+  for (int i = 0; i < iterations; i++) kernel();
+  return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char *argv[]) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 20000;
+
+  std::mt19937_64 rng(42);
+  std::vector<SimdLevel> levels;
+  for (int level = SIMD_SCALAR; level <= detectSimdLevel(); level++) {
+    levels.push_back(static_cast<SimdLevel>(level));
+  }
+
+  // Moduli of the NativePoly parameter sets, a DCRTPoly tower and edge cases
+  std::vector<uint64_t> moduli = {8383489, 16760833, 1073479681, 4294967291ULL,
+                                  4294967311ULL, 576460752303421441ULL, 4611686018427387847ULL};
+  std::vector<size_t> sizes = {1, 7, 31, 512, 1024};
+
+  for (uint64_t q : moduli) {
+    for (size_t n : sizes) {
+      KernelInput input = randomInput(n, q, &rng);
+
+      setSimdLevel(SIMD_SCALAR);
+      std::vector<uint64_t> expected = runKernels(input);
+
+      for (SimdLevel level : levels) {
+        setSimdLevel(level);
+        if (runKernels(input) != expected) {
+          std::cerr << "Mismatch at level " << simdLevelName(level) << " for q = " << q
+                    << " and n = " << n << std::endl;
+          return 1;
+        }
+      }
+    }
+  }
+  std::cout << "All levels match the scalar kernels" << std::endl << std::endl;
+
+  std::cout << std::setw(10) << "level" << std::setw(12) << "q bits" << std::setw(12) << "add ns"
+            << std::setw(12) << "sub ns" << std::setw(12) << "mulacc ns" << std::endl;
+
+  for (uint64_t q : {8383489ULL, 576460752303421441ULL}) {
+    KernelInput input = randomInput(1024, q, &rng);
+    std::vector<uint64_t> sum(input.a);
+    size_t n = sum.size();
+
+    for (SimdLevel level : levels) {
+      setSimdLevel(level);
+      double add = timeKernel(iterations, [&] { vectorModAdd(sum.data(), input.b.data(), n, q); });
+      double sub = timeKernel(iterations, [&] { vectorModSub(sum.data(), input.b.data(), n, q); });
+      double mulAcc = timeKernel(iterations, [&] {
+        vectorShoupMulAcc(sum.data(), input.x.data(), input.b.data(), input.shoup.data(), n, q);
+      });
+
+      std::cout << std::setw(10) << simdLevelName(level) << std::setw(12) << (64 - __builtin_clzll(q))
+                << std::setw(12) << std::fixed << std::setprecision(1) << add << std::setw(12) << sub
+                << std::setw(12) << mulAcc << std::endl;
+    }
+  }
+
+  setSimdLevel(detectSimdLevel());
+  return 0;
+}
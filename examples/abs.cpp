@@ -23,6 +23,7 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <ostream>
+#include <sstream>
 #include "signaturecontext.h"
 #include "abs.h"
 
@@ -90,10 +91,10 @@ int main() {
 
   // Sign the first plaintext with generated keys
   std::cout << "Signing first plaintext with user 1" << std::endl;
-  signatureABS signature1User1 = context.Sign(vk, user1AttrKey, attributesUser1, pt1);
+  signatureABS<Poly> signature1User1 = context.Sign(vk, user1AttrKey, attributesUser1, pt1);
 
   std::cout << "Signing first plaintext with user 2" << std::endl;
-  signatureABS signature1User2 = context.Sign(vk, user2AttrKey, attributesUser2, pt1);
+  signatureABS<Poly> signature1User2 = context.Sign(vk, user2AttrKey, attributesUser2, pt1);
 
   std::cout << std::endl;
 
@@ -122,5 +123,29 @@ int main() {
   std::cout << "Verif result 2 (signature of pt1, from user 2, with user 2 attributes, on message pt1): " << result2 << std::endl;
   std::cout << "Verif result 3 (signature of pt1, from user 1, with user 1 attributes, on message pt2): " << result3 << std::endl;
   std::cout << "Verif result 4 (signature of pt1, from user 2, with user 1 attributes, on message pt1): " << result4 << std::endl;
+
+  // The same checks can be done at once, sharing the work between signatures
+  vector<std::pair<signatureABS<Poly>, string>> batch;
+  batch.push_back(std::make_pair(signature1User1, pt1));
+  batch.push_back(std::make_pair(signature1User1, pt2));
+  batch.push_back(std::make_pair(signature1User2, pt1));
+  vector<bool> batchResult = context.VerifyBatch(vk, batch);
+
+  std::cout << "Batch verif results (results 1, 3 and 4): " << batchResult[0] << " "
+            << batchResult[1] << " " << batchResult[2] << std::endl;
+
+  // Signatures are shipped in a compact binary format
+  vector<uint8_t> encoded = context.SerializeSignature(signature1User1);
+  signatureABS<Poly> decoded = context.DeserializeSignature(encoded.data(), encoded.size());
+  std::cout << "Encoded signature size: " << encoded.size() << " bytes, verif result after decoding: "
+            << context.Verify(vk, decoded, pt1) << std::endl;
+
+  // Large messages are read from a stream (or a file descriptor, or a mapped
+  // file) and hashed in chunks, giving the same signatures as in memory ones
+  std::istringstream stream(pt1);
+  StreamMessageSource source(stream);
+  signatureABS<Poly> streamed = context.Sign(vk, user1AttrKey, attributesUser1, source);
+  std::cout << "Verif result of a streamed signature on message pt1: "
+            << context.Verify(vk, streamed, pt1) << std::endl;
   return 0;
 }
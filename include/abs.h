@@ -6,7 +6,13 @@
 #include <string>
 #include <vector>
 #include "math/matrix.h"
-#include "signature/signaturecontext.h"
+#include "messagesource.h"
+#include "sha256.h"
+#include "gpv.h"
+#include "syndromecache.h"
+#include "perturbationpool.h"
+#include "preparedkey.h"
+#include "subsetsum.h"
 
 using namespace lbcrypto;
 
@@ -19,46 +25,371 @@ const std::string attributesList[] = {
     "CP>80"
 };
 
+// Serialization of the ring element hashed together with the message into
+// the 32 bit tag. The value is the version stored in each signature, so
+// signatures made with an older encoding can still be verified
+enum TagEncoding : uint8_t {
+    // Decimal strings of the coefficients, as used by the first signatures
+    TAG_ENCODING_DECIMAL = 0,
+    // Fixed width little-endian coefficients streamed into SHA-256
+    TAG_ENCODING_BINARY = 1
+};
+
+// Hash from attribute strings to the ring elements of their public syndrome.
+// Keys only work with the syndromes they were extracted for, so the value is
+// stored in each signature as well
+enum AttributeHashMode : uint8_t {
+    // SHA-256 digests packed into the coefficients, as used by the first keys
+    ATTRIBUTE_HASH_SHA256_PACKED = 0,
+    // Coefficients uniform modulo q read from SHAKE128, one stream per element
+    ATTRIBUTE_HASH_SHAKE128 = 1
+};
+
+// Dense index of an attribute in an AttributeRegistry
+typedef uint32_t AttributeId;
+
+template <class Element>
+class AttributeRegistry;
+
+template <class Element>
 class signatureABS {
     public:
-        signatureABS(vector<string> attributesList, uint32_t signatureHash, Matrix<Poly> signature) {
-            this->attributeList = attributesList;
-            this->signatureHash = signatureHash;
-            this->signature = signature;
+        // The modes have no defaults, as a signature labelled with other
+        // modes than the ones it was made with fails verification silently
+        signatureABS(vector<string> attributesList, uint32_t signatureHash, Matrix<Element> signature,
+                     TagEncoding tagEncoding, AttributeHashMode hashMode)
+            : attributeList(std::move(attributesList)), signatureHash(signatureHash),
+              signature(std::move(signature)), tagEncoding(tagEncoding), hashMode(hashMode) {}
+
+        // Signature in the original format: decimal tag encoding and packed
+        // SHA-256 attribute hashes
+        static signatureABS legacy(vector<string> attributesList, uint32_t signatureHash, Matrix<Element> signature) {
+            return signatureABS(std::move(attributesList), signatureHash, std::move(signature),
+                                TAG_ENCODING_DECIMAL, ATTRIBUTE_HASH_SHA256_PACKED);
         }
 
-        vector<string> getAttributeList() {return this->attributeList;}
-        void setAttributeList(vector<string> attributeList) {this->attributeList = attributeList;}
+        // Empty signature, to be filled by the sign functions taking a
+        // workspace, which reuse its lattice point from one call to the next
+        signatureABS()
+            : signatureHash(0), tagEncoding(TAG_ENCODING_BINARY), hashMode(ATTRIBUTE_HASH_SHAKE128) {}
+
+        const vector<string> &getAttributeList() const {return this->attributeList;}
+        // Drops the ids as well, which belonged to the previous list
+        void setAttributeList(const vector<string> &attributeList) {
+            this->attributeList = attributeList;
+            this->attributeIds.clear();
+        }
 
-        uint32_t getSignatureHash() {return this->signatureHash;}
+        uint32_t getSignatureHash() const {return this->signatureHash;}
         void setSignatureHash(uint32_t signatureHash) {this->signatureHash = signatureHash;}
 
-        Matrix<Poly> getSignature() {return this->signature;}
-        void setSignature(Matrix<Poly> signature) {this->signature = signature;}
+        const Matrix<Element> &getSignature() const {return this->signature;}
+        Matrix<Element> &getSignature() {return this->signature;}
+        void setSignature(Matrix<Element> signature) {this->signature = std::move(signature);}
+
+        TagEncoding getTagEncoding() const {return this->tagEncoding;}
+        void setTagEncoding(TagEncoding tagEncoding) {this->tagEncoding = tagEncoding;}
+
+        AttributeHashMode getHashMode() const {return this->hashMode;}
+        void setHashMode(AttributeHashMode hashMode) {this->hashMode = hashMode;}
+
+        // Registry ids of the attribute list, in the same order, when the
+        // signature was made from ids. They are not serialized and only mean
+        // something to the registry that assigned them, so a signature read
+        // back carries the names only. Verify with a registry only uses the
+        // ids when each one names the attribute at its position, and looks
+        // the names up otherwise
+        const vector<AttributeId> &getAttributeIds() const {return this->attributeIds;}
+        void setAttributeIds(const vector<AttributeId> &attributeIds) {this->attributeIds = attributeIds;}
     private:
         vector<string> attributeList;
+        vector<AttributeId> attributeIds;
         uint32_t signatureHash;
-        Matrix<Poly> signature;
+        Matrix<Element> signature;
+        TagEncoding tagEncoding;
+        AttributeHashMode hashMode;
+};
+
+// Message independent part of a signature: the gaussian vector y and the tag
+// hash with the serialization of the secret A*y already absorbed. A nonce
+// must be used for a single signature, as two tags under the same y leak the
+// difference of their keys
+template <class Element>
+struct SignatureNonce {
+    SignatureNonce(Matrix<Element> y, TagEncoding encoding) : y(std::move(y)), encoding(encoding) {}
+
+    Matrix<Element> y;
+    TagEncoding encoding;
+    // Hash of the secret for the binary encoding
+    SHA256 secretHash;
+    // Decimal coefficients of the secret for the decimal encoding
+    std::string decimalSecret;
+};
+
+// Scratch space of the A*y or A*z product and of the tag hash. The
+// polynomials are allocated on first use and reused while the ring stays the
+// same
+template <class Element>
+struct TagWorkspace {
+    // Ring the polynomials below were allocated for
+    shared_ptr<typename Element::Params> params;
+    // A*y or A*z, in EVALUATION format
+    Element product;
+    // One term of the product, when there is no prepared key
+    Element term;
+    // Words of the prepared key product, with a sum and a column per
+    // intra-operation worker after the ones of the calling thread
+    vector<uint64_t> words;
+    SHA256 secretHash;
+    std::string decimalSecret;
+    // Partial product and term of each intra-operation worker, and the
+    // serialized product they hash, sized for the workers of the last call
+    vector<Element> partials;
+    vector<Element> terms;
+    vector<uint8_t> secretBytes;
+};
+
+// Scratch space kept by the caller between sign calls, so a warm workspace
+// samples and hashes without allocating. It serves one call at a time
+template <class Element>
+struct SignWorkspace : TagWorkspace<Element> {
+    // Gaussian coefficients of one polynomial of y
+    vector<int64_t> gaussian;
+    // That polynomial in COEFFICIENT format, before its NTT
+    Element sample;
+};
+
+// Scratch space kept by the caller between verify calls. The syndromes of the
+// last attribute set are kept as well, so a run of signatures over the same
+// attributes hashes them once. It serves one call at a time
+template <class Element>
+struct VerifyWorkspace : TagWorkspace<Element> {
+    // Attribute set and hash mode the syndromes below belong to
+    vector<string> attributes;
+    AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128;
+    bool hasSyndromes = false;
+    // Syndrome matrix of the set, unless it came as a subset sum table
+    Matrix<Element> syndromeMatrix;
+    shared_ptr<const SubsetSumTable<Element>> syndromeTable;
+    // Syndromes selected by the tag
+    Element syndromes;
 };
 
-void attributeHashGenerator(vector<string> attributes,
-                            shared_ptr<LPSignatureParameters<Poly>> sparams,
-                            Matrix<Poly> *syndromeMatrix);
-
-vector<shared_ptr<Matrix<Poly>>> extract(shared_ptr<lbcrypto::GPVSignatureParameters<Poly>> sparams,
-             const lbcrypto::GPVSignKey<Poly> &sk,
-             const lbcrypto::GPVVerificationKey<Poly> &vk,
-             vector<string> attributes);
-
-signatureABS sign(shared_ptr<GPVSignatureParameters<Poly>> m_params,
-                  vector<shared_ptr<Matrix<Poly>>> attributesKey,
-                  const lbcrypto::GPVVerificationKey<Poly> &vrificationKey,
-                  string message,
-                  vector<string> attributeList);
-
-bool verify(shared_ptr<GPVSignatureParameters<Poly>> m_params,
-            const lbcrypto::GPVVerificationKey<Poly> &verificationKey,
-            string message,
-            signatureABS signature);
+// Public syndrome of a single attribute: one polynomial per tag bit, in
+// EVALUATION format
+template <class Element>
+shared_ptr<const typename AttributeSyndromeCache<Element>::SyndromeRow> attributeSyndrome(
+    const string &attribute,
+    shared_ptr<GPVSignatureParameters<Element>> sparams,
+    AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128);
+
+template <class Element>
+void attributeHashGenerator(const vector<string> &attributes,
+                            shared_ptr<GPVSignatureParameters<Element>> sparams,
+                            Matrix<Element> *syndromeMatrix,
+                            AttributeSyndromeCache<Element> *cache = nullptr,
+                            AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128);
+
+template <class Element>
+vector<shared_ptr<Matrix<Element>>> extract(shared_ptr<lbcrypto::GPVSignatureParameters<Element>> sparams,
+             const lbcrypto::GPVSignKey<Element> &sk,
+             const lbcrypto::GPVVerificationKey<Element> &vk,
+             const vector<string> &attributes,
+             AttributeSyndromeCache<Element> *cache = nullptr,
+             usint numThreads = 0,
+             PerturbationPool<Element> *pool = nullptr,
+             AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128);
+
+// The functions taking a registry work on attribute ids, reading the
+// syndromes from its table instead of hashing the attribute strings. The
+// registry must have been built for the ring of the parameters, and its hash
+// mode is the one of the keys and signatures
+
+// Extracts an user key for a set of registered attributes
+template <class Element>
+vector<shared_ptr<Matrix<Element>>> extract(shared_ptr<lbcrypto::GPVSignatureParameters<Element>> sparams,
+             const lbcrypto::GPVSignKey<Element> &sk,
+             const lbcrypto::GPVVerificationKey<Element> &vk,
+             const AttributeRegistry<Element> &registry,
+             const vector<AttributeId> &attributes,
+             usint numThreads = 0,
+             PerturbationPool<Element> *pool = nullptr);
+
+template <class Element>
+signatureABS<Element> sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                  const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                  const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                  const string &message,
+                  const vector<string> &attributeList,
+                  TagEncoding encoding = TAG_ENCODING_BINARY,
+                  AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128,
+                  const PreparedVerificationKey<Element> *prepared = nullptr,
+                  const SubsetSumTable<Element> *keyTable = nullptr);
+
+// Signs a message read from a source. The message is hashed in chunks, so it
+// is never held in memory as a whole
+template <class Element>
+signatureABS<Element> sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                  const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                  const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                  ABSMessageSource &message,
+                  const vector<string> &attributeList,
+                  TagEncoding encoding = TAG_ENCODING_BINARY,
+                  AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128,
+                  const PreparedVerificationKey<Element> *prepared = nullptr,
+                  const SubsetSumTable<Element> *keyTable = nullptr);
+
+// Signs into an existing signature with the scratch space of a workspace.
+// Once both have been used for the same ring, the call does not allocate
+template <class Element>
+void sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+          const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+          const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+          ABSMessageSource &message,
+          const vector<string> &attributeList,
+          SignWorkspace<Element> *workspace,
+          signatureABS<Element> *signature,
+          TagEncoding encoding = TAG_ENCODING_BINARY,
+          AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128,
+          const PreparedVerificationKey<Element> *prepared = nullptr,
+          const SubsetSumTable<Element> *keyTable = nullptr);
+
+// Signs a message for a set of registered attributes. The signature carries
+// both the ids and their names, so it serializes as any other
+template <class Element>
+signatureABS<Element> sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                  const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                  const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                  ABSMessageSource &message,
+                  const AttributeRegistry<Element> &registry,
+                  const vector<AttributeId> &attributes,
+                  TagEncoding encoding = TAG_ENCODING_BINARY,
+                  const PreparedVerificationKey<Element> *prepared = nullptr,
+                  const SubsetSumTable<Element> *keyTable = nullptr);
+
+// The A*y and A*z products of the functions below use the prepared key when
+// one is given, which must have been prepared from the same verification key.
+// The keys selected by the tag are added through keyTable when one is given,
+// which must have been built from attributesKey. The syndromes are added
+// through the tables of syndromeTables when one is given, building and caching
+// the table of each attribute set the first time it is seen
+
+// Signs many messages with the same attribute based key. The y vectors and
+// their A*y products are computed in parallel, and the key is not copied
+template <class Element>
+vector<signatureABS<Element>> signBatch(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                               const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                               const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                               const vector<string> &messages,
+                               const vector<string> &attributeList,
+                               TagEncoding encoding = TAG_ENCODING_BINARY,
+                               usint numThreads = 0,
+                               AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128,
+                               const PreparedVerificationKey<Element> *prepared = nullptr,
+                               const SubsetSumTable<Element> *keyTable = nullptr);
+
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            const string &message,
+            const signatureABS<Element> &signature,
+            AttributeSyndromeCache<Element> *cache = nullptr,
+            const PreparedVerificationKey<Element> *prepared = nullptr,
+            SubsetSumTableCache<Element> *syndromeTables = nullptr);
+
+// Verifies a signature of a message read from a source, hashed in chunks
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            ABSMessageSource &message,
+            const signatureABS<Element> &signature,
+            AttributeSyndromeCache<Element> *cache = nullptr,
+            const PreparedVerificationKey<Element> *prepared = nullptr,
+            SubsetSumTableCache<Element> *syndromeTables = nullptr);
+
+// Verifies with the scratch space of a workspace. Once it has been used for
+// the same ring and attribute set, the call does not allocate
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            ABSMessageSource &message,
+            const signatureABS<Element> &signature,
+            VerifyWorkspace<Element> *workspace,
+            AttributeSyndromeCache<Element> *cache = nullptr,
+            const PreparedVerificationKey<Element> *prepared = nullptr,
+            SubsetSumTableCache<Element> *syndromeTables = nullptr);
+
+// Verifies a signature with the syndromes of a registry: through its ids when
+// it has them, and otherwise through the ids of its names. Throws config_error
+// if its hash mode is not the one of the registry or an attribute is not
+// registered
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            ABSMessageSource &message,
+            const signatureABS<Element> &signature,
+            const AttributeRegistry<Element> &registry,
+            const PreparedVerificationKey<Element> *prepared = nullptr,
+            VerifyWorkspace<Element> *workspace = nullptr);
+
+// First half of verify: the sum of the attribute syndromes selected by the
+// tag of a signature. It depends on the attributes and the tag only, so it can
+// be computed apart from the message
+template <class Element>
+Element signatureSyndrome(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                          const signatureABS<Element> &signature,
+                          AttributeSyndromeCache<Element> *cache = nullptr,
+                          SubsetSumTableCache<Element> *syndromeTables = nullptr);
+
+// Second half of verify: checks the tag of a signature against A*z minus its
+// syndrome sum, hashed with the message
+template <class Element>
+bool verifyWithSyndromeSum(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                           const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                           const signatureABS<Element> &signature,
+                           const Element &syndromes,
+                           ABSMessageSource &message,
+                           const PreparedVerificationKey<Element> *prepared = nullptr);
+
+// Offline phase of sign: samples y and hashes the secret A*y, which does not
+// depend on the message nor on the attribute key
+template <class Element>
+shared_ptr<SignatureNonce<Element>> signOffline(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                               const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                                               TagEncoding encoding = TAG_ENCODING_BINARY,
+                                               const PreparedVerificationKey<Element> *prepared = nullptr);
+
+// Online phase of sign: finishes the tag with the message and adds the
+// selected keys to y. The vector is moved out of the nonce, which can not be
+// used again
+template <class Element>
+signatureABS<Element> signOnline(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                 const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                                 SignatureNonce<Element> *nonce,
+                                 const string &message,
+                                 const vector<string> &attributeList,
+                                 AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128,
+                                 const SubsetSumTable<Element> *keyTable = nullptr);
+
+template <class Element>
+signatureABS<Element> signOnline(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                 const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                                 SignatureNonce<Element> *nonce,
+                                 ABSMessageSource &message,
+                                 const vector<string> &attributeList,
+                                 AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128,
+                                 const SubsetSumTable<Element> *keyTable = nullptr);
+
+// Verifies many (signature, message) pairs under the same verification key,
+// generating the syndrome of each distinct attribute set only once. Returns
+// one result per pair, in order
+template <class Element>
+vector<bool> verifyBatch(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                         const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                         const vector<std::pair<signatureABS<Element>, string>> &batch,
+                         AttributeSyndromeCache<Element> *cache = nullptr,
+                         usint numThreads = 0,
+                         const PreparedVerificationKey<Element> *prepared = nullptr,
+                         SubsetSumTableCache<Element> *syndromeTables = nullptr);
 
 #endif // __ABS_H_
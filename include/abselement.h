@@ -0,0 +1,304 @@
+#ifndef __ABSELEMENT_H_
+#define __ABSELEMENT_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "lattice/backend.h"
+#include "sha256.h"
+#include "shake128.h"
+
+using namespace lbcrypto;
+
+// Element specific parts of the ABS functions. The templates cover the single
+// modulus elements (Poly and NativePoly), while DCRTPoly has its own
+// overloads that work tower by tower.
+
+// Appends the decimal value of every coefficient, as hashed by the legacy tag
+// encoding
+template <class Element>
+void appendDecimalCoefficients(const Element &element, string *out) {
+    for (usint i = 0; i < element.GetLength(); i++) {
+        out->append(element[i].ToString());
+    }
+}
+
+// Streams every coefficient into the hash, little-endian in the byte width of
+// the modulus
+template <class Element>
+void hashCoefficients(const Element &element, SHA256 *hash) {
+    size_t width = (element.GetModulus().GetMSB() + 7) / 8;
+    if (width > 8) {
+        PALISADE_THROW(math_error, "Binary tag encoding needs a modulus of at most 64 bits");
+    }
+
+    uint8_t buffer[512];
+    size_t used = 0;
+
+    for (usint i = 0; i < element.GetLength(); i++) {
+        if (used + width > sizeof(buffer)) {
+            hash->update(buffer, used);
+            used = 0;
+        }
+
+        uint64_t coefficient = element[i].ConvertToInt();
+        for (size_t b = 0; b < width; b++) {
+            buffer[used++] = static_cast<uint8_t>(coefficient >> (8 * b));
+        }
+    }
+    hash->update(buffer, used);
+}
+
+// Same bytes as hashCoefficients, written to out by threads workers so the
+// hash can absorb them in one call. coefficientBytes is the size out needs
+template <class Element>
+size_t coefficientBytes(const Element &element) {
+    return size_t(element.GetLength()) * ((element.GetModulus().GetMSB() + 7) / 8);
+}
+
+template <class Element>
+void serializeCoefficients(const Element &element, uint8_t *out, usint threads) {
+    size_t width = (element.GetModulus().GetMSB() + 7) / 8;
+    if (width > 8) {
+        PALISADE_THROW(math_error, "Binary tag encoding needs a modulus of at most 64 bits");
+    }
+
+    int length = static_cast<int>(element.GetLength());
+
+#pragma omp parallel for schedule(static) num_threads(threads)
+    for (int i = 0; i < length; i++) {
+        uint64_t coefficient = element[i].ConvertToInt();
+        uint8_t *bytes = out + size_t(i) * width;
+        for (size_t b = 0; b < width; b++) {
+            bytes[b] = static_cast<uint8_t>(coefficient >> (8 * b));
+        }
+    }
+}
+
+// Same string as appendDecimalCoefficients, built in one slice of the
+// coefficients per worker and joined in order
+template <class Element>
+void appendDecimalCoefficients(const Element &element, string *out, usint threads) {
+    int length = static_cast<int>(element.GetLength());
+    int slices = static_cast<int>(threads);
+    vector<string> parts(slices);
+
+#pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int s = 0; s < slices; s++) {
+        for (int i = length * s / slices; i < length * (s + 1) / slices; i++) {
+            parts[s].append(element[i].ToString());
+        }
+    }
+
+    for (const string &part : parts) {
+        out->append(part);
+    }
+}
+
+// Fills an allocated ring element with values uniform modulo its modulus, read
+// from the XOF by rejection sampling. Each candidate takes the bytes of the
+// modulus width, with the bits above its MSB masked off, so at least half of
+// the candidates are accepted
+template <class Element>
+void sampleUniform(SHAKE128 *xof, Element *element) {
+    typedef typename Element::Integer Integer;
+
+    const Integer &modulus = element->GetModulus();
+    usint bits = modulus.GetMSB();
+    usint limbs = (bits + 63) / 64;
+    size_t topBytes = ((bits - 1) % 64) / 8 + 1;
+    uint64_t topMask = (bits % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (bits % 64)) - 1;
+
+    uint8_t buffer[8];
+
+    for (usint i = 0; i < element->GetLength(); i++) {
+        while (true) {
+            // Most significant limb first, only its used bytes are read
+            Integer candidate(0);
+            for (usint l = 0; l < limbs; l++) {
+                size_t width = (l == 0) ? topBytes : 8;
+                xof->squeeze(buffer, width);
+
+                uint64_t limb = 0;
+                for (size_t b = 0; b < width; b++) {
+                    limb |= uint64_t(buffer[b]) << (8 * b);
+                }
+                if (l == 0) {
+                    limb &= topMask;
+                    candidate = Integer(limb);
+                } else {
+                    candidate = (candidate << 64) + Integer(limb);
+                }
+            }
+
+            if (candidate < modulus) {
+                (*element)[i] = candidate;
+                break;
+            }
+        }
+    }
+}
+
+// Reads the coefficients of an element in COEFFICIENT format as centered
+// values in (-q/2, q/2]. Throws math_error if one does not fit in 64 bits
+template <class Element>
+void getCenteredCoefficients(const Element &element, vector<int64_t> *out) {
+    typedef typename Element::Integer Integer;
+
+    const Integer &modulus = element.GetModulus();
+    Integer half = modulus >> 1;
+
+    out->resize(element.GetLength());
+
+    for (usint i = 0; i < element.GetLength(); i++) {
+        const Integer &coefficient = element[i];
+        bool negative = coefficient > half;
+        Integer magnitude = negative ? modulus - coefficient : coefficient;
+
+        if (magnitude.GetMSB() > 63) {
+            PALISADE_THROW(math_error, "Coefficient too large for a centered 64 bit value");
+        }
+
+        uint64_t value = magnitude.ConvertToInt();
+        (*out)[i] = negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    }
+}
+
+// Sets the coefficients of an allocated element in COEFFICIENT format from
+// centered values. Throws math_error if a value is not smaller than q
+template <class Element>
+void setCenteredCoefficients(const int64_t *values, Element *element) {
+    typedef typename Element::Integer Integer;
+
+    const Integer &modulus = element->GetModulus();
+
+    for (usint i = 0; i < element->GetLength(); i++) {
+        bool negative = values[i] < 0;
+        uint64_t value = negative ? uint64_t(0) - uint64_t(values[i]) : uint64_t(values[i]);
+        Integer magnitude(value);
+
+        if (!(magnitude < modulus)) {
+            PALISADE_THROW(math_error, "Centered coefficient out of the modulus range");
+        }
+
+        (*element)[i] = (negative && value != 0) ? modulus - magnitude : magnitude;
+    }
+}
+
+// Copies the coefficients as 64 bit words, in the current format. Throws
+// math_error for moduli wider than 64 bits
+template <class Element>
+void exportCoefficients(const Element &element, uint64_t *out) {
+    if (element.GetModulus().GetMSB() > 64) {
+        PALISADE_THROW(math_error, "Raw coefficients need a modulus of at most 64 bits");
+    }
+
+    for (usint i = 0; i < element.GetLength(); i++) {
+        out[i] = element[i].ConvertToInt();
+    }
+}
+
+// Sets the coefficients of an allocated element from 64 bit words, which must
+// already be reduced modulo q
+template <class Element>
+void importCoefficients(const uint64_t *in, Element *element) {
+    typedef typename Element::Integer Integer;
+
+    for (usint i = 0; i < element->GetLength(); i++) {
+        (*element)[i] = Integer(in[i]);
+    }
+}
+
+// Reads the modulus and root of unity of each tower of the ring. Throws
+// math_error for moduli wider than 64 bits
+template <class Integer>
+void getRingModuli(const ILParamsImpl<Integer> &params, vector<NativeInteger> *moduli, vector<NativeInteger> *rootsOfUnity) {
+    if (params.GetModulus().GetMSB() > 64) {
+        PALISADE_THROW(math_error, "Ring moduli must fit 64 bits");
+    }
+
+    moduli->assign(1, NativeInteger(params.GetModulus().ConvertToInt()));
+    rootsOfUnity->assign(1, NativeInteger(params.GetRootOfUnity().ConvertToInt()));
+}
+
+// Rebuilds the ring parameters and the NTT tables from moduli found before,
+// without searching for primes or roots of unity
+template <class Element>
+shared_ptr<typename Element::Params> buildRingParams(usint order, const vector<NativeInteger> &moduli, const vector<NativeInteger> &rootsOfUnity) {
+    typedef typename Element::Integer Integer;
+
+    if (moduli.size() != 1 || rootsOfUnity.size() != 1) {
+        PALISADE_THROW(config_error, "Single modulus rings have exactly one tower");
+    }
+
+    Integer modulus(moduli[0].ConvertToInt());
+    Integer rootOfUnity(rootsOfUnity[0].ConvertToInt());
+
+    ChineseRemainderTransformFTT<typename Element::Vector>::PreCompute(rootOfUnity, order, modulus);
+    DiscreteFourierTransform::PreComputeTable(order);
+
+    return std::make_shared<ILParamsImpl<Integer>>(order, modulus, rootOfUnity);
+}
+
+// Bytes of the coefficient storage of one ring element, or of one tower for
+// DCRTPoly, which is the block size the slab allocator serves for the ring
+template <class Element>
+size_t coefficientBlockBytes(const shared_ptr<typename Element::Params> &params) {
+    return size_t(params->GetRingDimension()) * sizeof(typename Element::Integer);
+}
+
+// In place a += b and a -= b. The generic versions use the element operators,
+// NativePoly and DCRTPoly go through the vector kernels
+template <class Element>
+void addInPlace(Element *a, const Element &b) {
+    *a += b;
+}
+
+template <class Element>
+void subInPlace(Element *a, const Element &b) {
+    *a -= b;
+}
+
+// The composite modulus is rebuilt from the towers, as for a single modulus
+void appendDecimalCoefficients(const DCRTPoly &element, string *out);
+
+// Every tower is streamed in order with the width of its own modulus
+void hashCoefficients(const DCRTPoly &element, SHA256 *hash);
+
+void appendDecimalCoefficients(const DCRTPoly &element, string *out, usint threads);
+
+// The towers are written one after the other, each with its own width
+size_t coefficientBytes(const DCRTPoly &element);
+void serializeCoefficients(const DCRTPoly &element, uint8_t *out, usint threads);
+
+// Every tower is sampled in order from the same stream, which by the CRT is a
+// uniform element modulo the composite modulus
+void sampleUniform(SHAKE128 *xof, DCRTPoly *element);
+
+// Small coefficients have the same centered value in every tower, which is
+// checked so the values read are those of the composite element
+void getCenteredCoefficients(const DCRTPoly &element, vector<int64_t> *out);
+
+// The same centered values are written to every tower
+void setCenteredCoefficients(const int64_t *values, DCRTPoly *element);
+
+void addInPlace(NativePoly *a, const NativePoly &b);
+void subInPlace(NativePoly *a, const NativePoly &b);
+void addInPlace(DCRTPoly *a, const DCRTPoly &b);
+void subInPlace(DCRTPoly *a, const DCRTPoly &b);
+
+// The towers are stored one after the other
+void exportCoefficients(const DCRTPoly &element, uint64_t *out);
+void importCoefficients(const uint64_t *in, DCRTPoly *element);
+
+void getRingModuli(const ILDCRTParams<BigInteger> &params, vector<NativeInteger> *moduli, vector<NativeInteger> *rootsOfUnity);
+
+template <>
+inline size_t coefficientBlockBytes<DCRTPoly>(const shared_ptr<DCRTPoly::Params> &params) {
+    return size_t(params->GetRingDimension()) * sizeof(NativeInteger);
+}
+
+template <>
+shared_ptr<DCRTPoly::Params> buildRingParams<DCRTPoly>(usint order, const vector<NativeInteger> &moduli, const vector<NativeInteger> &rootsOfUnity);
+
+#endif // __ABSELEMENT_H_
@@ -0,0 +1,30 @@
+#ifndef __ABSPARALLEL_H_
+#define __ABSPARALLEL_H_
+
+#include "utils/inttypes.h"
+
+// Intra-operation parallelism. At ring dimensions of 2048 and up a single
+// sign or verify is long enough to split its steps (the column products of
+// A*y and A*z, the 32 polynomials of each attribute syndrome, the sum of the
+// selected keys and the serialization of the tag) among the OpenMP workers.
+// The number of workers is a setting of the calling thread, so the batch
+// functions, which already run one operation per worker, never nest.
+
+// Workers the operations of the calling thread split their steps among. 1,
+// the default, runs every step on the calling thread
+usint absIntraOpThreads();
+
+// Sets the intra-operation workers of the calling thread, 0 meaning every
+// core, for the lifetime of the scope
+class ABSIntraOpScope {
+    public:
+        explicit ABSIntraOpScope(usint threads);
+        ~ABSIntraOpScope();
+
+        ABSIntraOpScope(const ABSIntraOpScope &) = delete;
+        ABSIntraOpScope &operator=(const ABSIntraOpScope &) = delete;
+    private:
+        usint previous;
+};
+
+#endif // __ABSPARALLEL_H_
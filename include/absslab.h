@@ -0,0 +1,98 @@
+#ifndef __ABSSLAB_H_
+#define __ABSSLAB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Slab allocator for the coefficient storage of ring elements.
+//
+// Ring elements of a context all allocate blocks of the same few sizes (the
+// ring dimension times the width of a coefficient), and a signer allocates
+// and frees them by the thousands per second from many threads. Built with
+// WITH_ABS_SLAB, the global operator new hands the requests of these sizes to
+// this allocator once it is enabled, and everything else to malloc.
+//
+// Blocks are carved from 2 MiB slabs of a single reserved address range,
+// each slab serving one block size. Every thread keeps a cache of free blocks
+// per size, so most allocations and frees touch no lock and no shared cache
+// line; the caches trade batches of blocks with a global list per size. The
+// range is reserved once and never returned, so freed blocks are reused but
+// the memory they used is not given back to the system.
+
+// Maximum number of block sizes served from slabs
+const size_t ABS_SLAB_CLASSES = 8;
+
+// Bytes of a slab, the size of a huge page on x86-64
+const size_t ABS_SLAB_BYTES = size_t(2) << 20;
+
+struct ABSSlabConfig {
+    // Block sizes served from slabs, added to the ones of previous calls. A
+    // request goes to the smallest size that fits it, if it is more than half
+    // of that size
+    std::vector<size_t> blockSizes;
+    // Address range reserved for the slabs on the first call. Pages are only
+    // backed once used, and the requests that do not fit go to malloc
+    size_t reserveBytes = size_t(4) << 30;
+    // Back the slabs with huge pages: explicit ones (MAP_HUGETLB) if the
+    // system has enough reserved for the whole range, transparent ones
+    // otherwise
+    bool hugePages = false;
+    // Free blocks a thread keeps per size before handing half of them back
+    size_t threadCacheBlocks = 256;
+};
+
+enum ABSSlabPages {
+    ABS_SLAB_PAGES_NONE = 0,
+    ABS_SLAB_PAGES_NORMAL,
+    ABS_SLAB_PAGES_TRANSPARENT_HUGE,
+    ABS_SLAB_PAGES_HUGETLB
+};
+
+struct ABSSlabStats {
+    // Whether new requests are served from slabs
+    bool enabled;
+    // How the range is backed, NONE before the first successful enable
+    ABSSlabPages pages;
+    // Block sizes served
+    std::vector<size_t> blockSizes;
+    // Slabs carved so far, and the bytes they span
+    uint64_t slabs;
+    uint64_t slabBytes;
+    // Batches of blocks moved from the global lists to a thread cache, and back
+    uint64_t refills;
+    uint64_t flushes;
+    // Requests of a served size that went to malloc because the range was full
+    uint64_t exhausted;
+};
+
+// Starts serving the block sizes of the config from slabs, reserving the
+// range on the first call. Returns false, serving nothing, if the range can
+// not be reserved, a size is larger than a slab, there would be more than
+// ABS_SLAB_CLASSES sizes, or the build has no WITH_ABS_SLAB
+bool absSlabEnable(const ABSSlabConfig &config);
+
+// Stops serving new requests from slabs. Blocks already handed out are still
+// freed to their slabs
+void absSlabDisable();
+
+bool absSlabEnabled();
+
+ABSSlabStats absSlabStats();
+
+// Block of at least size bytes from a slab, or nullptr if the allocator is
+// disabled, no block size fits or the range is full
+void *absSlabAllocate(size_t size);
+
+// True if the pointer was returned by absSlabAllocate
+bool absSlabOwns(const void *ptr);
+
+// Gives a block back to the cache of the calling thread
+void absSlabFree(void *ptr);
+
+// Resident and peak resident memory of the process, in bytes, or 0 where the
+// system does not report them
+size_t absResidentBytes();
+size_t absPeakResidentBytes();
+
+#endif // __ABSSLAB_H_
@@ -0,0 +1,121 @@
+#ifndef __ABSSTATS_H_
+#define __ABSSTATS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <chrono>
+#include <string>
+
+// Phases timed by the instrumentation. The first ones are the steps inside
+// the ABS and GPV functions, the last ones the whole SignatureContext calls
+enum ABSPhase {
+    // Syndrome matrix of an attribute set (attributeHashGenerator)
+    ABS_PHASE_ATTRIBUTE_HASH = 0,
+    // Syndrome of a single attribute not found in the cache
+    ABS_PHASE_ATTRIBUTE_SYNDROME,
+    // Gaussian preimage of one syndrome during extraction
+    ABS_PHASE_PREIMAGE_SAMPLING,
+    // Gaussian y vector of a signature
+    ABS_PHASE_GAUSSIAN_SAMPLING,
+    // Format switches (NTTs) of the ABS functions
+    ABS_PHASE_NTT,
+    // A*y and A*z products
+    ABS_PHASE_PUBLIC_PRODUCT,
+    // Serialization and hashing of A*y into the tag
+    ABS_PHASE_TAG_SECRET,
+    // Hashing of the message into the tag
+    ABS_PHASE_TAG_MESSAGE,
+    // Sum of the attribute keys selected by the tag
+    ABS_PHASE_KEY_ACCUMULATION,
+    // Sum of the syndromes selected by the tag
+    ABS_PHASE_SYNDROME_ACCUMULATION,
+    // Construction of a subset sum table
+    ABS_PHASE_SUBSET_SUM_BUILD,
+    // Base GPV scheme
+    ABS_PHASE_GPV_KEYGEN,
+    ABS_PHASE_GPV_SIGN,
+    ABS_PHASE_GPV_SAMPLE_OFFLINE,
+    ABS_PHASE_GPV_SIGN_ONLINE,
+    ABS_PHASE_GPV_VERIFY,
+    // SignatureContext operations
+    ABS_PHASE_EXTRACT,
+    ABS_PHASE_SIGN,
+    ABS_PHASE_SIGN_BATCH,
+    ABS_PHASE_VERIFY,
+    ABS_PHASE_VERIFY_BATCH,
+    ABS_PHASE_COUNT
+};
+
+// Latency histograms have power of two buckets: bucket i counts the calls
+// that took from 2^i to 2^(i+1) - 1 nanoseconds, the last one everything
+// longer (about 18 minutes)
+const size_t ABS_STATS_BUCKETS = 40;
+
+struct ABSPhaseStats {
+    uint64_t calls;
+    uint64_t totalNs;
+    uint64_t maxNs;
+    uint64_t histogram[ABS_STATS_BUCKETS];
+};
+
+// Counters of every phase, summed over all the threads
+struct ABSStatsSnapshot {
+    bool enabled;
+    ABSPhaseStats phases[ABS_PHASE_COUNT];
+};
+
+// Name of a phase, as used in the JSON output
+const char *absPhaseName(ABSPhase phase);
+
+// Sums the counters of every thread, including the threads already gone.
+// Recording never takes a lock, so the counters are read while the threads
+// keep updating them
+ABSStatsSnapshot absStatsSnapshot();
+
+// Zeroes every counter. Calls finishing at the same time may be kept
+void absStatsReset();
+
+// Upper bound, in nanoseconds, of the histogram bucket holding the given
+// fraction of the calls of a phase, 0 when there are no calls
+uint64_t absStatsPercentile(const ABSPhaseStats &stats, double fraction);
+
+// Adds one call to a set of counters kept by the caller, for latencies
+// measured outside the phases
+void absStatsAdd(ABSPhaseStats *stats, uint64_t ns);
+
+// Snapshot as a JSON object, for scraping
+std::string absStatsJson(const ABSStatsSnapshot &snapshot);
+
+// Adds one call of a phase to the counters of the calling thread
+void absStatsRecord(ABSPhase phase, uint64_t ns);
+
+// Times the scope it lives in as one call of a phase
+class ABSPhaseTimer {
+    public:
+        explicit ABSPhaseTimer(ABSPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+
+        ~ABSPhaseTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - this->start;
+            absStatsRecord(this->phase, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+
+        ABSPhaseTimer(const ABSPhaseTimer &) = delete;
+        ABSPhaseTimer &operator=(const ABSPhaseTimer &) = delete;
+
+    private:
+        ABSPhase phase;
+        std::chrono::steady_clock::time_point start;
+};
+
+// ABS_STATS_PHASE(phase) times the rest of the enclosing scope. Without
+// WITH_ABS_STATS it expands to nothing, so the instrumentation has no cost
+#define ABS_STATS_CONCAT_(a, b) a##b
+#define ABS_STATS_CONCAT(a, b) ABS_STATS_CONCAT_(a, b)
+
+#ifdef WITH_ABS_STATS
+#define ABS_STATS_PHASE(phase) ABSPhaseTimer ABS_STATS_CONCAT(absPhaseTimer, __LINE__)(phase)
+#else
+#define ABS_STATS_PHASE(phase) do {} while (0)
+#endif
+
+#endif // __ABSSTATS_H_
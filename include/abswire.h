@@ -0,0 +1,69 @@
+#ifndef __ABSWIRE_H_
+#define __ABSWIRE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+#include "abs.h"
+
+using namespace lbcrypto;
+
+// Compact binary encoding of signatureABS, all integers being varints unless
+// stated otherwise:
+//
+//   magic "ABS" | version (1 byte) | tag encoding (1 byte) | hash mode (1 byte)
+//   tag (4 bytes, big-endian)
+//   attribute count | for each attribute: length, bytes
+//   rows | cols | ring dimension | Rice parameter (1 byte)
+//   coefficient stream length | coefficient stream
+//
+// The lattice point z is stored in COEFFICIENT format, where it is gaussian
+// small: each centered coefficient is zigzag mapped and Golomb-Rice coded with
+// a parameter chosen for the whole signature. Polynomials follow the matrix
+// in row major order, coefficients in index order.
+
+const uint8_t ABS_WIRE_MAGIC[3] = {'A', 'B', 'S'};
+const uint8_t ABS_WIRE_VERSION = 1;
+
+// Parsed layout of an encoded signature. The attributes and the coefficient
+// stream point into the encoded buffer, which must outlive the view
+struct SignatureWireView {
+    uint8_t version;
+    TagEncoding tagEncoding;
+    AttributeHashMode hashMode;
+    uint32_t tag;
+    vector<std::pair<const char *, size_t>> attributes;
+    usint rows;
+    usint cols;
+    usint ringDimension;
+    uint8_t riceParameter;
+    const uint8_t *coefficients;
+    size_t coefficientsSize;
+};
+
+// Encodes a signature. Throws math_error if z is not small enough to be
+// stored with centered 64 bit coefficients
+template <class Element>
+vector<uint8_t> serializeSignature(const signatureABS<Element> &signature);
+
+// Parses the layout of an encoded signature without copying or decoding the
+// coefficients, checking it against the ring of the parameters. Throws
+// deserialize_error on malformed or incompatible data
+template <class Element>
+void parseSignature(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                    const uint8_t *data, size_t size,
+                    SignatureWireView *view);
+
+// Decodes the coefficients of a parsed signature straight into its lattice
+// point, in EVALUATION format
+template <class Element>
+signatureABS<Element> decodeSignature(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                      const SignatureWireView &view);
+
+// Parses and decodes an encoded signature
+template <class Element>
+signatureABS<Element> deserializeSignature(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                           const uint8_t *data, size_t size);
+
+#endif // __ABSWIRE_H_
@@ -0,0 +1,88 @@
+#ifndef __ATTRIBUTEREGISTRY_H_
+#define __ATTRIBUTEREGISTRY_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "abs.h"
+
+using namespace lbcrypto;
+
+// Fixed universe of attributes interned to dense ids 0..size()-1, with the
+// public syndrome of every attribute precomputed when the registry is built.
+//
+// The 32 polynomials of each attribute (EVALUATION format) are stored one
+// attribute after the other in a single table, so the syndrome of an id set
+// is found by indexing the table and adding, without hashing, encoding or
+// comparing strings. A registry only fits the ring parameters and the hash
+// mode it was built with, and is read-only once built, so any number of
+// threads can share it.
+template <class Element>
+class AttributeRegistry {
+    public:
+        // Interns the attributes in order and computes their syndromes with
+        // numThreads workers (0 uses every core). Throws config_error if an
+        // attribute is repeated
+        AttributeRegistry(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                          const vector<string> &attributes,
+                          AttributeHashMode hashMode = ATTRIBUTE_HASH_SHAKE128,
+                          usint numThreads = 0);
+
+        AttributeRegistry(const AttributeRegistry &) = delete;
+        AttributeRegistry &operator=(const AttributeRegistry &) = delete;
+
+        size_t size() const {return this->names.size();}
+        AttributeHashMode getHashMode() const {return this->hashMode;}
+
+        // True if the registry was built for the ring of these parameters
+        bool isBuiltFor(shared_ptr<GPVSignatureParameters<Element>> m_params) const {
+            return this->params == m_params->GetILParams();
+        }
+
+        // Name of an id, throws config_error if it is not registered
+        const string &getName(AttributeId id) const;
+
+        // Names of an id set, in the same order
+        vector<string> getNames(const vector<AttributeId> &ids) const;
+
+        // Sets id and returns true if the attribute is registered
+        bool find(const string &attribute, AttributeId *id) const;
+
+        // Ids of a set of attributes. Returns false, leaving ids unspecified,
+        // if any of them is not registered
+        bool findAll(const vector<string> &attributes, vector<AttributeId> *ids) const;
+
+        // Ids of a set of attributes, throws config_error if any of them is
+        // not registered
+        vector<AttributeId> getIds(const vector<string> &attributes) const;
+
+        // True if there are as many ids as attributes and each id is
+        // registered under the attribute at its position
+        bool matches(const vector<AttributeId> &ids, const vector<string> &attributes) const;
+
+        // Polynomial of one tag bit of the syndrome of an attribute
+        const Element &getSyndrome(AttributeId id, usint bit) const {
+            return this->table[size_t(id) * 32 + bit];
+        }
+
+        // Adds the syndromes of an id set to the 1 x 32 syndrome matrix
+        void syndromeMatrix(const vector<AttributeId> &ids, Matrix<Element> *syndromeMatrix) const;
+
+        // Adds to sum the syndromes of an id set selected by the bits of a tag
+        void accumulate(const vector<AttributeId> &ids, uint32_t h, Element *sum) const;
+
+    private:
+        // Throws config_error if any id is not registered
+        void checkIds(const vector<AttributeId> &ids) const;
+
+        shared_ptr<typename Element::Params> params;
+        AttributeHashMode hashMode;
+        vector<string> names;
+        std::unordered_map<string, AttributeId> ids;
+        // 32 polynomials per attribute, in id order
+        vector<Element> table;
+};
+
+#endif // __ATTRIBUTEREGISTRY_H_
@@ -30,8 +30,10 @@
 #ifndef SIGNATURE_LWESIGN_H
 #define SIGNATURE_LWESIGN_H
 
+#include <atomic>
 #include <cmath>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -161,6 +163,7 @@ class GPVSignatureParameters : public LPSignatureParameters<Element> {
       m_dggLargeSigma = typename Element::DggType(sqrt(s * s - c * c));
     else
       m_dggLargeSigma = m_dgg;
+    m_generation = NextGeneration();
   }
 
   /**
@@ -200,6 +203,28 @@ class GPVSignatureParameters : public LPSignatureParameters<Element> {
     return m_dggLargeSigma;
   }
 
+  /**
+   *Method for accessing a copy of the DiscreteGaussianGenerator private to
+   *the calling thread, so concurrent samplings never share generator state.
+   *The copy is taken on the first use, later changes to the shared generator
+   *are not seen
+   *
+   *@return DiscreteGaussianGenerator object of the calling thread
+   */
+  typename Element::DggType& GetThreadDiscreteGaussianGenerator() const {
+    return ThreadGenerators().dgg;
+  }
+
+  /**
+   *Method for accessing a copy of the high distribution parameter
+   *DiscreteGaussianGenerator private to the calling thread
+   *
+   *@return DiscreteGaussianGenerator object of the calling thread
+   */
+  typename Element::DggType& GetThreadDiscreteGaussianGeneratorLargeSigma() const {
+    return ThreadGenerators().dggLargeSigma;
+  }
+
   /**
    *Constructor
    *@param params Parameters used in Element construction
@@ -219,9 +244,35 @@ class GPVSignatureParameters : public LPSignatureParameters<Element> {
       m_dggLargeSigma = typename Element::DggType(sqrt(s * s - c * c));
     else
       m_dggLargeSigma = m_dgg;
+    m_generation = NextGeneration();
   }
 
  private:
+  // Copies of the generators of one parameter set, owned by a thread
+  struct ThreadLocalGenerators {
+    uint64_t generation = 0;
+    typename Element::DggType dgg;
+    typename Element::DggType dggLargeSigma;
+  };
+
+  // Each thread keeps the copies of the last parameter set it sampled with.
+  // They are copied again when another set is used, which the generation
+  // tells apart even if it lives at the address of a freed one
+  ThreadLocalGenerators& ThreadGenerators() const {
+    static thread_local ThreadLocalGenerators generators;
+    if (generators.generation != m_generation) {
+      generators.dgg = m_dgg;
+      generators.dggLargeSigma = m_dggLargeSigma;
+      generators.generation = m_generation;
+    }
+    return generators;
+  }
+
+  static uint64_t NextGeneration() {
+    static std::atomic<uint64_t> counter(0);
+    return ++counter;
+  }
+
   // Parameters related to elements
   shared_ptr<typename Element::Params> m_params;
   // Discrete Gaussian Generator for random number generation
@@ -233,6 +284,8 @@ class GPVSignatureParameters : public LPSignatureParameters<Element> {
   usint m_base;
   // Trapdoor length
   usint m_k;
+  // Identifies the generators of this object to the thread local copies
+  uint64_t m_generation;
   /*
    *@brief Overloaded dummy method
    */
@@ -346,7 +399,7 @@ class GPVSignatureScheme : public LPSignatureScheme<Element> {
   /**
    * Default constructor
    */
-  GPVSignatureScheme() : seed(0) {}
+  GPVSignatureScheme() : seed(std::make_shared<const std::vector<char>>()) {}
 
   /**
    *Method for signing given text
@@ -414,7 +467,11 @@ class GPVSignatureScheme : public LPSignatureScheme<Element> {
               LPSignKey<Element>* sk, LPVerificationKey<Element>* vk);
 
  private:
-  std::vector<char> seed;
+  // Random bytes appended to the digest of short messages. KeyGen replaces
+  // the vector instead of changing it, so concurrent signers keep reading
+  // the one they took
+  shared_ptr<const std::vector<char>> seed;
+  std::mutex seedMutex;
   /*
    *@brief Overloaded dummy method
    */
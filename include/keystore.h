@@ -0,0 +1,171 @@
+// @file keystore.h - Memory mapped store for GPV parameters and keys
+
+#ifndef __KEYSTORE_H_
+#define __KEYSTORE_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include "gpv.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief Fixed size header at the start of a key store file. The sections it
+ * points to are 64 byte aligned arrays of 64 bit words in host byte order
+ */
+struct KeyStoreHeader {
+  // KEYSTORE_MAGIC
+  char magic[8];
+  uint32_t version;
+  // KEYSTORE_BYTE_ORDER as written by the host that made the file
+  uint32_t byteOrder;
+  uint32_t cyclotomicOrder;
+  uint32_t ringDimension;
+  // Number of moduli, 1 unless the ring is in RNS form
+  uint32_t numTowers;
+  // Gadget base and length
+  uint32_t base;
+  uint32_t k;
+  // KEYSTORE_HAS_SIGN_KEY if the trapdoor is stored
+  uint32_t flags;
+  double stddev;
+  // Dimensions of A, and of each of the trapdoor matrices r and e
+  uint32_t vkRows;
+  uint32_t vkCols;
+  uint32_t skRows;
+  uint32_t skCols;
+  // Byte offsets of the sections: moduli and roots of unity hold one word per
+  // tower, keys hold numTowers * ringDimension words per polynomial in
+  // EVALUATION format, polynomials in row major order, r before e
+  uint64_t moduliOffset;
+  uint64_t rootsOffset;
+  uint64_t verificationKeyOffset;
+  uint64_t signKeyOffset;
+  uint64_t fileSize;
+};
+
+const char KEYSTORE_MAGIC[8] = {'L', 'A', 'B', 'S', 'K', 'E', 'Y', 'S'};
+const uint32_t KEYSTORE_VERSION = 1;
+const uint32_t KEYSTORE_BYTE_ORDER = 0x01020304;
+const uint32_t KEYSTORE_HAS_SIGN_KEY = 1;
+
+/**
+ * @brief Reads the header of a store without mapping it, e.g. to pick the
+ * ring element it must be loaded with
+ * @param path File to be read
+ * @param header Header of the file - Output
+ * @return false if the file cannot be read or is not a key store
+ */
+inline bool ReadKeyStoreHeader(const string& path, KeyStoreHeader* header) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == nullptr) return false;
+  bool ok = fread(header, sizeof(*header), 1, file) == 1 &&
+            memcmp(header->magic, KEYSTORE_MAGIC, sizeof(KEYSTORE_MAGIC)) == 0;
+  fclose(file);
+  return ok;
+}
+
+/**
+ * @brief Read-only key store file mapped in memory.
+ *
+ * Loading the parameters only rebuilds the NTT tables, skipping the prime and
+ * root of unity search, and loading the keys skips the trapdoor generation.
+ * The mapping is shared, so verifiers on the same host share the key pages.
+ * Files are trusted: their coefficients are not checked against the moduli.
+ * @tparam Element ring element
+ */
+template <class Element>
+class KeyStore {
+ public:
+  /**
+   *@brief Writes parameters and keys to a new store, replacing the file
+   * atomically so processes mapping the old one are not disturbed
+   *@param path File to be written
+   *@param params Parameters of the keys
+   *@param vk Verification key
+   *@param sk Sign key, or nullptr for a verifier only store
+   */
+  static void Write(const string& path,
+                    shared_ptr<GPVSignatureParameters<Element>> params,
+                    const GPVVerificationKey<Element>& vk,
+                    const GPVSignKey<Element>* sk = nullptr);
+
+  /**
+   *@brief Maps a store and rebuilds its parameters
+   *@param path File to be mapped
+   */
+  explicit KeyStore(const string& path);
+
+  /**
+   *@brief Destructor, unmaps the file
+   */
+  ~KeyStore();
+
+  KeyStore(const KeyStore&) = delete;
+  KeyStore& operator=(const KeyStore&) = delete;
+
+  /**
+   *@brief Returns the header of the mapped file
+   */
+  const KeyStoreHeader& GetHeader() const { return *m_header; }
+
+  /**
+   *@brief Returns the parameters rebuilt from the store
+   */
+  shared_ptr<GPVSignatureParameters<Element>> GetParams() const {
+    return m_params;
+  }
+
+  /**
+   *@brief Returns true if the store holds the trapdoor
+   */
+  bool HasSignKey() const {
+    return (m_header->flags & KEYSTORE_HAS_SIGN_KEY) != 0;
+  }
+
+  /**
+   *@brief Loads the verification key. Every call shares the matrix read when
+   * the store was mapped, so a key prepared from the store is bound to all of
+   * them
+   *@param vk Verification key - Output
+   */
+  void LoadVerificationKey(GPVVerificationKey<Element>* vk) const;
+
+  /**
+   *@brief Loads the sign key, throws config_error if it is not stored
+   *@param sk Sign key - Output
+   */
+  void LoadSignKey(GPVSignKey<Element>* sk) const;
+
+  /**
+   *@brief Returns the mapped coefficients of the verification key, laid out
+   * as described in KeyStoreHeader
+   */
+  const uint64_t* GetVerificationKeyData() const {
+    return Section(m_header->verificationKeyOffset);
+  }
+
+ private:
+  const uint64_t* Section(uint64_t offset) const {
+    return reinterpret_cast<const uint64_t*>(
+        static_cast<const uint8_t*>(m_data) + offset);
+  }
+
+  // Reads a matrix of polynomials starting at the given word
+  Matrix<Element> LoadMatrix(const uint64_t* words, uint32_t rows,
+                             uint32_t cols) const;
+
+  void* m_data;
+  size_t m_size;
+  const KeyStoreHeader* m_header;
+  shared_ptr<GPVSignatureParameters<Element>> m_params;
+  // Verification key read from the mapping, shared by LoadVerificationKey
+  shared_ptr<Matrix<Element>> m_verificationKey;
+};
+
+}  // namespace lbcrypto
+
+#endif  // __KEYSTORE_H_
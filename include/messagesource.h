@@ -0,0 +1,88 @@
+#ifndef __MESSAGESOURCE_H_
+#define __MESSAGESOURCE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Size of the chunks the message sources hand out by default
+const size_t ABS_MESSAGE_CHUNK_SIZE = 64 * 1024;
+
+// Single pass source of the bytes of a message, so sign and verify can hash
+// messages that do not fit in memory. The message is read in chunks, with
+// memory use bounded by the chunk size of the source
+class ABSMessageSource {
+    public:
+        virtual ~ABSMessageSource() {}
+
+        // Points chunk to the next bytes of the message and returns how many
+        // there are, 0 once the message is over. The bytes stay valid until
+        // the next call
+        virtual size_t next(const uint8_t **chunk) = 0;
+};
+
+// Message already in memory, handed out without copies
+class MemoryMessageSource : public ABSMessageSource {
+    public:
+        MemoryMessageSource(const void *data, size_t size)
+            : data(static_cast<const uint8_t *>(data)), size(size) {}
+        explicit MemoryMessageSource(const std::string &message)
+            : MemoryMessageSource(message.data(), message.size()) {}
+
+        size_t next(const uint8_t **chunk) override;
+
+    private:
+        const uint8_t *data;
+        size_t size;
+};
+
+// Message read from a stream until its end
+class StreamMessageSource : public ABSMessageSource {
+    public:
+        explicit StreamMessageSource(std::istream &stream, size_t chunkSize = ABS_MESSAGE_CHUNK_SIZE)
+            : stream(stream), buffer(chunkSize) {}
+
+        size_t next(const uint8_t **chunk) override;
+
+    private:
+        std::istream &stream;
+        std::vector<uint8_t> buffer;
+};
+
+// Message read from a file descriptor until its end. The descriptor is not
+// closed, and pipes and sockets work as well as files
+class FileDescriptorMessageSource : public ABSMessageSource {
+    public:
+        explicit FileDescriptorMessageSource(int fd, size_t chunkSize = ABS_MESSAGE_CHUNK_SIZE)
+            : fd(fd), buffer(chunkSize) {}
+
+        size_t next(const uint8_t **chunk) override;
+
+    private:
+        int fd;
+        std::vector<uint8_t> buffer;
+};
+
+// Whole file mapped in memory and handed out in chunks without copies. The
+// kernel is told the file is read sequentially, so it reads ahead and drops
+// the pages already hashed first
+class MappedFileMessageSource : public ABSMessageSource {
+    public:
+        explicit MappedFileMessageSource(const std::string &path, size_t chunkSize = ABS_MESSAGE_CHUNK_SIZE);
+        ~MappedFileMessageSource();
+
+        MappedFileMessageSource(const MappedFileMessageSource &) = delete;
+        MappedFileMessageSource &operator=(const MappedFileMessageSource &) = delete;
+
+        size_t next(const uint8_t **chunk) override;
+
+    private:
+        void *mapping;
+        size_t size;
+        size_t offset;
+        size_t chunkSize;
+};
+
+#endif // __MESSAGESOURCE_H_
@@ -0,0 +1,74 @@
+// @file perturbationpool.h - Pool of precomputed perturbation vectors for the
+// GPV preimage sampling
+
+#ifndef SIGNATURE_PERTURBATIONPOOL_H
+#define SIGNATURE_PERTURBATIONPOOL_H
+
+#include <memory>
+
+#include "gpv.h"
+#include "precomputepool.h"
+
+namespace lbcrypto {
+/**
+ *@brief Bounded pool of perturbation vectors sampled with GaussSampOffline
+ *by background threads for a single sign key. Every vector is handed out only
+ *once, so each GaussSampOnline call still gets a fresh perturbation.
+ *@tparam Element ring element
+ */
+template <class Element>
+class PerturbationPool {
+ public:
+  /**
+   *@brief Constructor, starts refilling the pool right away
+   *@param params Parameters used for the scheme
+   *@param signKey Sign key whose trapdoor the perturbations are sampled for
+   *@param config Watermarks, number of workers and refill rate
+   */
+  PerturbationPool(shared_ptr<GPVSignatureParameters<Element>> params,
+                   const GPVSignKey<Element>& signKey,
+                   const PrecomputePoolConfig& config = PrecomputePoolConfig());
+
+  /**
+   *@brief Method for removing a perturbation vector from the pool. If the pool
+   *is empty the vector is sampled inline and a starvation is counted
+   *@return a perturbation vector never handed out before
+   */
+  shared_ptr<Matrix<Element>> Take() { return m_pool.Take(); }
+
+  /**
+   *@brief Method for checking if the pool samples for a given sign key
+   *@param signKey Sign key to be checked
+   *@return true if both keys share the same trapdoor
+   */
+  bool IsBoundTo(const GPVSignKey<Element>& signKey) const {
+    return &signKey.GetSignKey() == &m_signKey.GetSignKey();
+  }
+
+  /**
+   *@brief Method for accessing the underlying pool, to tune or observe it
+   *@return the pool of perturbation vectors
+   */
+  PrecomputePool<shared_ptr<Matrix<Element>>>& GetPool() { return m_pool; }
+
+  /**
+   *@brief Method for reading the pool counters
+   *@return a snapshot of the pool counters
+   */
+  PrecomputePoolStats GetStats() const { return m_pool.GetStats(); }
+
+ private:
+  // Builds a producer with its own copy of the gaussian generators
+  typename PrecomputePool<shared_ptr<Matrix<Element>>>::Producer MakeProducer();
+
+  // Parameters used in the sampling
+  shared_ptr<GPVSignatureParameters<Element>> m_params;
+  // Sign key holding the trapdoor used in the sampling
+  GPVSignKey<Element> m_signKey;
+  // Pool of sampled perturbation vectors, must be the last member so the
+  // workers are stopped before the rest of the object is destroyed
+  PrecomputePool<shared_ptr<Matrix<Element>>> m_pool;
+};
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,241 @@
+#ifndef __PRECOMPUTEPOOL_H_
+#define __PRECOMPUTEPOOL_H_
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "utils/inttypes.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief Tuning knobs of a PrecomputePool
+ */
+struct PrecomputePoolConfig {
+  // The workers start refilling once the pool holds less items than this
+  size_t lowWatermark = 8;
+  // The workers stop refilling once the pool holds this many items
+  size_t highWatermark = 32;
+  // Number of background threads refilling the pool
+  usint workers = 1;
+  // Maximum number of items produced per second by all workers, 0 = no limit
+  double refillRate = 0;
+};
+
+/**
+ * @brief Counters describing the state of a PrecomputePool
+ */
+struct PrecomputePoolStats {
+  // Items currently available
+  size_t size = 0;
+  // Items produced by the background workers
+  uint64_t produced = 0;
+  // Items handed out by Take, from the pool or not
+  uint64_t taken = 0;
+  // Takes that found the pool empty and had to compute the item inline
+  uint64_t starvations = 0;
+  // Number of times the pool dropped below the low watermark
+  uint64_t refills = 0;
+};
+
+/**
+ * @brief Bounded pool of precomputed values, refilled by background threads.
+ *
+ * The values are produced by callables built by the given factory. Each
+ * worker builds its own producer, so producers may keep per-thread state
+ * (e.g. gaussian generators). Take never blocks: when the pool is empty the
+ * value is computed inline by the caller and counted as a starvation. Inline
+ * producers are built on the first starvation of each concurrent caller and
+ * kept for the next ones.
+ * @tparam T type of the precomputed values
+ */
+template <class T>
+class PrecomputePool {
+ public:
+  typedef std::function<T()> Producer;
+  typedef std::function<Producer()> ProducerFactory;
+
+  /**
+   *@brief Constructor, starts the background workers
+   *@param factory Builds the producers of the pool values
+   *@param config Watermarks, number of workers and refill rate
+   */
+  PrecomputePool(ProducerFactory factory,
+                 const PrecomputePoolConfig& config = PrecomputePoolConfig())
+      : m_factory(factory), m_config(config), m_stop(false),
+        m_refilling(true), m_inFlight(0), m_nextSlot(Clock::now()) {
+    if (m_config.highWatermark < m_config.lowWatermark)
+      m_config.highWatermark = m_config.lowWatermark;
+    // The pool starts empty, so the first refill begins right away
+    m_stats.refills = 1;
+    for (usint i = 0; i < m_config.workers; i++)
+      m_workers.emplace_back(&PrecomputePool::Refill, this);
+  }
+
+  /**
+   *@brief Destructor, stops and joins the background workers
+   */
+  ~PrecomputePool() {
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_stop = true;
+    }
+    m_wakeup.notify_all();
+    for (auto& worker : m_workers) worker.join();
+  }
+
+  PrecomputePool(const PrecomputePool&) = delete;
+  PrecomputePool& operator=(const PrecomputePool&) = delete;
+
+  /**
+   *@brief Removes a value from the pool, computing it inline if it is empty
+   *@return a value never handed out before
+   */
+  T Take() {
+    {
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_stats.taken++;
+      if (!m_items.empty()) {
+        T item = std::move(m_items.front());
+        m_items.pop_front();
+        CheckLowWatermark();
+        return item;
+      }
+      m_stats.starvations++;
+      CheckLowWatermark();
+    }
+    return ProduceInline();
+  }
+
+  /**
+   *@brief Changes the watermarks, taking effect on the next refill check
+   */
+  void SetWatermarks(size_t low, size_t high) {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_config.lowWatermark = low;
+    m_config.highWatermark = high < low ? low : high;
+    CheckLowWatermark();
+  }
+
+  /**
+   *@brief Changes the maximum number of values produced per second
+   *@param rate values per second, 0 removes the limit
+   */
+  void SetRefillRate(double rate) {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_config.refillRate = rate;
+  }
+
+  /**
+   *@brief Returns the current configuration of the pool
+   */
+  PrecomputePoolConfig GetConfig() const {
+    std::lock_guard<std::mutex> guard(m_lock);
+    return m_config;
+  }
+
+  /**
+   *@brief Returns a snapshot of the pool counters
+   */
+  PrecomputePoolStats GetStats() const {
+    std::lock_guard<std::mutex> guard(m_lock);
+    PrecomputePoolStats stats = m_stats;
+    stats.size = m_items.size();
+    return stats;
+  }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  // Wakes the workers up when the pool falls below the low watermark, the
+  // lock must be held
+  void CheckLowWatermark() {
+    if (!m_refilling && m_items.size() < m_config.lowWatermark) {
+      m_refilling = true;
+      m_stats.refills++;
+      m_wakeup.notify_all();
+    }
+  }
+
+  // Computes a value on the calling thread with a spare inline producer,
+  // building one only when every spare is in use by another caller
+  T ProduceInline() {
+    Producer produce;
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      if (!m_spareProducers.empty()) {
+        produce = std::move(m_spareProducers.back());
+        m_spareProducers.pop_back();
+      }
+    }
+    if (!produce) produce = m_factory();
+
+    T item = produce();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_spareProducers.push_back(std::move(produce));
+    return item;
+  }
+
+  // Worker loop, produces values while the pool is being refilled
+  void Refill() {
+    Producer produce = m_factory();
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true) {
+      m_wakeup.wait(lock, [this] {
+        return m_stop || (m_refilling &&
+                          m_items.size() + m_inFlight < m_config.highWatermark);
+      });
+      if (m_stop) return;
+
+      // Reserve a production slot respecting the refill rate
+      Clock::time_point slot = Clock::now();
+      if (m_config.refillRate > 0) {
+        if (slot < m_nextSlot) slot = m_nextSlot;
+        m_nextSlot = slot + std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(1.0 / m_config.refillRate));
+      }
+      m_inFlight++;
+      lock.unlock();
+
+      std::this_thread::sleep_until(slot);
+      T item = produce();
+
+      lock.lock();
+      m_inFlight--;
+      m_items.push_back(std::move(item));
+      m_stats.produced++;
+      if (m_items.size() >= m_config.highWatermark) m_refilling = false;
+    }
+  }
+
+  ProducerFactory m_factory;
+  PrecomputePoolConfig m_config;
+  PrecomputePoolStats m_stats;
+
+  std::deque<T> m_items;
+  std::vector<std::thread> m_workers;
+  // Inline producers of Take not in use, one per caller starving at once
+  std::vector<Producer> m_spareProducers;
+  mutable std::mutex m_lock;
+  std::condition_variable m_wakeup;
+
+  // Set when the pool is being destroyed
+  bool m_stop;
+  // Set between the low watermark being crossed and the high one being reached
+  bool m_refilling;
+  // Values being produced right now
+  size_t m_inFlight;
+  // Earliest start of the next production when the refill rate is limited
+  Clock::time_point m_nextSlot;
+};
+
+}  // namespace lbcrypto
+
+#endif  // __PRECOMPUTEPOOL_H_
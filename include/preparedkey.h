@@ -0,0 +1,114 @@
+// @file preparedkey.h - Verification key laid out for the A*z product
+
+#ifndef SIGNATURE_PREPAREDKEY_H
+#define SIGNATURE_PREPAREDKEY_H
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "gpv.h"
+#include "keystore.h"
+
+namespace lbcrypto {
+/**
+ *@brief Verification key A stored as contiguous 64 bit words together with
+ *the Shoup constant of every coefficient. The product A*z of the 1 x m key
+ *with a signature vector is computed in a single pass over the key, with one
+ *conditional subtraction per term instead of a full modular reduction, and
+ *without building temporary matrices.
+ *
+ *Every tower modulus must be below 2^62, so the lazily reduced sums in
+ *[0, 2q) never overflow a word.
+ *@tparam Element ring element
+ */
+template <class Element>
+class PreparedVerificationKey {
+ public:
+  /**
+   *@brief Constructor, copies the key and computes its constants
+   *@param params Parameters used for the scheme
+   *@param vk Verification key to be prepared
+   */
+  PreparedVerificationKey(shared_ptr<GPVSignatureParameters<Element>> params,
+                          const GPVVerificationKey<Element>& vk);
+
+  /**
+   *@brief Constructor reading the key straight from a mapped key store, which
+   *must outlive the prepared key. Only the constants are computed, and the
+   *key is bound to the verification keys loaded from the store
+   *@param store Key store holding the verification key
+   */
+  explicit PreparedVerificationKey(const KeyStore<Element>& store);
+
+  // Copies would share the borrowed values of the original
+  PreparedVerificationKey(const PreparedVerificationKey&) = delete;
+  PreparedVerificationKey& operator=(const PreparedVerificationKey&) = delete;
+
+  /**
+   *@brief Method for checking if every modulus of a ring fits the lazy
+   *reduction
+   *@param params Ring parameters to be checked
+   *@return true if a key over this ring can be prepared
+   */
+  static bool IsSupported(shared_ptr<typename Element::Params> params);
+
+  /**
+   *@brief Method for checking if this was prepared from a given key
+   *@param vk Verification key to be checked
+   *@return true if both keys share the same matrix
+   */
+  bool IsBoundTo(const GPVVerificationKey<Element>& vk) const {
+    return m_hasKey && &vk.GetVerificationKey() == &m_vk.GetVerificationKey();
+  }
+
+  /**
+   *@brief Method for computing the product with a column vector
+   *@param z m x 1 vector in EVALUATION format
+   *@return the only entry of A*z, in EVALUATION format
+   */
+  Element Multiply(const Matrix<Element>& z) const;
+
+  /**
+   *@brief Method for computing the product with a column vector into an
+   *existing element, so that repeated products do not allocate
+   *@param z m x 1 vector in EVALUATION format
+   *@param result Ring element already allocated over the ring of the key,
+   *overwritten with the only entry of A*z in EVALUATION format - Output
+   *@param scratch Words reused between calls
+   */
+  void Multiply(const Matrix<Element>& z, Element* result, vector<uint64_t>* scratch) const;
+
+  /**
+   *@brief Method for accessing the number of columns of A
+   */
+  usint GetCols() const { return m_cols; }
+
+ private:
+  // Checks the moduli and computes the Shoup constants of m_values
+  void Precompute();
+
+  // Adds column j of the product to sum, kept in [0, 2q), through the
+  // column words
+  void AccumulateColumn(const Matrix<Element>& z, usint j, uint64_t* sum, uint64_t* column) const;
+
+  shared_ptr<typename Element::Params> m_params;
+  // Key the values were copied from, if any
+  GPVVerificationKey<Element> m_vk;
+  bool m_hasKey;
+
+  usint m_ringDimension;
+  usint m_towers;
+  usint m_cols;
+  vector<uint64_t> m_moduli;
+
+  // Coefficients of A, column after column and tower after tower within a
+  // column: either m_ownedValues or the mapped key store
+  vector<uint64_t> m_ownedValues;
+  const uint64_t* m_values;
+  // floor(a * 2^64 / q) for every coefficient a, same layout as m_values
+  vector<uint64_t> m_shoup;
+};
+}  // namespace lbcrypto
+
+#endif
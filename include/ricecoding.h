@@ -0,0 +1,40 @@
+#ifndef __RICECODING_H_
+#define __RICECODING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using std::vector;
+
+// Quotients from this value on are not written in unary: the escape code is
+// followed by the raw 64 bit value, which bounds the size of outliers
+const uint32_t RICE_ESCAPE = 32;
+
+// Appends an unsigned LEB128 varint
+void writeVarint(uint64_t value, vector<uint8_t> *out);
+
+// Reads an unsigned LEB128 varint at *offset, moving the offset past it.
+// Returns false if the buffer ends first or the value overflows 64 bits
+bool readVarint(const uint8_t *data, size_t size, size_t *offset, uint64_t *value);
+
+// Maps signed values to unsigned ones with the small magnitudes first
+inline uint64_t zigzagEncode(int64_t value) {
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Rice parameter giving (close to) the shortest code for the zigzag values
+uint8_t riceParameter(const vector<uint64_t> &values);
+
+// Appends the Golomb-Rice code of the values, padded to a whole byte
+void riceEncode(const vector<uint64_t> &values, uint8_t parameter, vector<uint8_t> *out);
+
+// Decodes count values from the stream, reading nothing beyond size bytes.
+// Returns false if the stream is truncated
+bool riceDecode(const uint8_t *data, size_t size, uint8_t parameter, uint64_t *values, size_t count);
+
+#endif // __RICECODING_H_
@@ -0,0 +1,34 @@
+#ifndef __SHA256_H_
+#define __SHA256_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremental SHA-256 (FIPS 180-4), so large or scattered inputs can be hashed
+// without first being concatenated into a single buffer
+class SHA256 {
+    public:
+        static const size_t DIGEST_SIZE = 32;
+
+        SHA256() {reset();}
+
+        // Restarts the hash computation
+        void reset();
+
+        // Absorbs len bytes of data
+        void update(const void *data, size_t len);
+
+        // Writes the 32 byte digest of everything absorbed so far. The object
+        // must be reset before being used again
+        void final(uint8_t digest[DIGEST_SIZE]);
+
+    private:
+        void compress(const uint8_t block[64]);
+
+        uint32_t state[8];
+        uint8_t buffer[64];
+        size_t bufferLength;
+        uint64_t totalLength;
+};
+
+#endif // __SHA256_H_
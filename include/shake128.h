@@ -0,0 +1,37 @@
+#ifndef __SHAKE128_H_
+#define __SHAKE128_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Incremental SHAKE128 extendable output function (FIPS 202). Data is absorbed
+// with update, then any number of output bytes is read with squeeze
+class SHAKE128 {
+    public:
+        // Bytes absorbed or squeezed per permutation
+        static const size_t RATE = 168;
+
+        SHAKE128() {reset();}
+
+        // Restarts the computation, ready to absorb
+        void reset();
+
+        // Absorbs len bytes of data, not allowed once squeezing started
+        void update(const void *data, size_t len);
+
+        // Writes the next len bytes of output. Successive calls continue the
+        // same output stream
+        void squeeze(void *out, size_t len);
+
+    private:
+        void permute();
+        void xorByte(size_t position, uint8_t value);
+        uint8_t getByte(size_t position) const;
+
+        uint64_t state[25];
+        // Position inside the current block, for absorbing or squeezing
+        size_t position;
+        bool squeezing;
+};
+
+#endif // __SHAKE128_H_
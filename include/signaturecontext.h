@@ -25,14 +25,27 @@
 #ifndef SIGNATURE_SIGNATURECONTEXT_H
 #define SIGNATURE_SIGNATURECONTEXT_H
 
+#include <iterator>
 #include <memory>
 
 #include "gpv.h"
 #include "abs.h"
+#include "absslab.h"
+#include "absstats.h"
+#include "abswire.h"
+#include "attributeregistry.h"
+#include "keystore.h"
+#include "perturbationpool.h"
+#include "signingpool.h"
 
 namespace lbcrypto {
 /**
- *@brief Context class for signature schemes, including GPV
+ *@brief Context class for signature schemes, including GPV. Once configured,
+ *a context can be shared by many threads: KeyGen, Extract, Sign, Verify and
+ *their batch versions may run concurrently, as the parameters are only read,
+ *the gaussian generators are copied per thread and the caches lock
+ *themselves. The configuration methods (GenerateGPVContext, Enable, Set and
+ *Prepare ones) must not run concurrently with any other call
  *@tparam Element ring element
  */
   template <class Element>
@@ -43,7 +56,8 @@ namespace lbcrypto {
        */
       SignatureContext() {}
       /**
-       *@brief Method for setting up a GPV context with specific parameters
+       *@brief Method for setting up a GPV context with specific parameters.
+       * For DCRTPoly the modulus is split into word-sized towers
        *@param ringsize Desired ringsize
        *@param bitwidth Desired modulus bitwidth
        *@param base Base of the gadget matrix
@@ -51,15 +65,52 @@ namespace lbcrypto {
       void GenerateGPVContext(usint ringsize, usint bitwidth, usint base);
       /**
        *@brief Method for setting up a GPV context with desired ring size only
-       *@param ringsize Desired ring size
+       *@param ringsize Desired ring size: 512, 1024, 2048 or 4096
        */
       void GenerateGPVContext(usint ringsize);
+      /**
+       *@brief Method for setting up a GPV context with the parameters of a key
+       *store, without searching for primes. When the moduli allow it, the
+       *verification key is prepared over the mapped words of the store, for
+       *the keys loaded from it, so the store must outlive the context
+       *@param store Key store the keys will be loaded from
+       */
+      void GenerateGPVContext(const KeyStore<Element>& store);
+      /**
+       *@brief Method for saving the context parameters and its keys in a key
+       *store file
+       *@param path File to be written
+       *@param vk Verification key
+       *@param sk Sign key, or nullptr to store the verification key only
+       */
+      void SaveKeyStore(const string& path, const LPVerificationKey<Element>& vk,
+                        const LPSignKey<Element>* sk = nullptr) const;
       /**
        *@brief Method for key generation
        *@param sk Signing key for sign operation - Output
        *@param vk Verification key for verify operation - Output
        */
       void KeyGen(LPSignKey<Element>* sk, LPVerificationKey<Element>* vk);
+      /**
+       *@brief Method for signing a given plaintext with the GPV scheme
+       *@param pt Plaintext to be signed
+       *@param sk Sign key
+       *@param vk Verification key
+       *@param sign Signature corresponding to the plaintext - Output
+       */
+      void Sign(const LPSignPlaintext<Element>& pt, const LPSignKey<Element>& sk,
+                const LPVerificationKey<Element>& vk,
+                LPSignature<Element>* signatureText);
+      /**
+       *@brief Method for verifying a GPV signature of a given plaintext
+       *@param pt Plaintext whose signature is checked
+       *@param signature Signature to be checked
+       *@param vk Verification key
+       *@return true if the signature is valid
+       */
+      bool Verify(const LPSignPlaintext<Element>& pt,
+                  const LPSignature<Element>& signature,
+                  const LPVerificationKey<Element>& vk);
       /**
        *@brief Method for offline phase of signing a given plaintext
        *@param pt Plaintext to be signed
@@ -82,6 +133,58 @@ namespace lbcrypto {
                            const LPVerificationKey<Element>& vk,
                            const PerturbationVector<Element> pv,
                            LPSignature<Element>* signatureText);
+      /**
+       *@brief Method for online phase of signing a given plaintext, taking the
+       *perturbation vector from the pool enabled for the sign key
+       *@param pt Plaintext to be signed
+       *@param sk Sign key
+       *@param vk Verification key
+       *@param sign Signature corresponding to the plaintext - Output
+       */
+      void SignOnlinePhase(const LPSignPlaintext<Element>& pt,
+                           const LPSignKey<Element>& sk,
+                           const LPVerificationKey<Element>& vk,
+                           LPSignature<Element>* signatureText);
+      /**
+       *@brief Method for keeping a pool of perturbation vectors, refilled in
+       *background, for the online sampling of SignOnlinePhase and Extract
+       *@param sk Sign key the perturbations are sampled for
+       *@param config Watermarks, number of workers and refill rate
+       */
+      void EnablePerturbationPool(const LPSignKey<Element>& sk,
+                                  const PrecomputePoolConfig& config = PrecomputePoolConfig());
+      /**
+       *@brief Method for stopping the perturbation pool workers
+       */
+      void DisablePerturbationPool() { m_perturbationPool.reset(); }
+      /**
+       *@brief Method for accessing the perturbation pool, to tune or observe it
+       *@return the pool, or nullptr when it is not enabled
+       */
+      shared_ptr<PerturbationPool<Element>> GetPerturbationPool() const {
+        return m_perturbationPool;
+      }
+      /**
+       *@brief Method for keeping a pool of signature nonces, refilled in
+       *background, so Sign only hashes the message and adds the keys. The
+       *nonces are made with the current tag encoding and the prepared key, if
+       *vk was prepared before
+       *@param vk Verification key the signatures are made for
+       *@param config Watermarks, number of workers and refill rate
+       */
+      void EnableSigningPool(const LPVerificationKey<Element>& vk,
+                             const PrecomputePoolConfig& config = PrecomputePoolConfig());
+      /**
+       *@brief Method for stopping the signing pool workers
+       */
+      void DisableSigningPool() { m_signingPool.reset(); }
+      /**
+       *@brief Method for accessing the signing pool, to tune or observe it
+       *@return the pool, or nullptr when it is not enabled
+       */
+      shared_ptr<SigningPool<Element>> GetSigningPool() const {
+        return m_signingPool;
+      }
       /**
        *@brief Method for key generation
        *@param sk Signing key for sign operation - Output
@@ -89,24 +192,375 @@ namespace lbcrypto {
        */
       void Setup(LPSignKey<Element>* sk, LPVerificationKey<Element>* vk);
 
-      vector<shared_ptr<Matrix<Poly>>> Extract(const LPSignKey<Element>& sk,
+      vector<shared_ptr<Matrix<Element>>> Extract(const LPSignKey<Element>& sk,
                                                const LPVerificationKey<Element>& vk,
-                                               vector<string> attributes);
-      signatureABS Sign(const LPVerificationKey<Element>& vk,
-                                       vector<shared_ptr<Matrix<Poly>>> attributesKey,
-                                       vector<string> attributeList,
-                                       string message);
+                                               const vector<string>& attributes);
+      /**
+       *@brief Method for extracting an user key for registered attributes,
+       *whose syndromes are read from the attribute registry
+       *@param sk Sign key of the attribute authority
+       *@param vk Verification key of the attribute authority
+       *@param attributes Ids of the attributes, see AttributeIds
+       *@return the attribute key
+       */
+      vector<shared_ptr<Matrix<Element>>> Extract(const LPSignKey<Element>& sk,
+                                               const LPVerificationKey<Element>& vk,
+                                               const vector<AttributeId>& attributes);
+      signatureABS<Element> Sign(const LPVerificationKey<Element>& vk,
+                                 const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                 const vector<string>& attributeList,
+                                 const string& message);
+      /**
+       *@brief Method for signing a message read from a source, such as a file
+       *descriptor, a stream or a mapped file. The message is hashed in chunks
+       *and never held in memory as a whole
+       *@param vk Verification key
+       *@param attributesKey Attribute key of the signer
+       *@param attributeList Attributes of the key
+       *@param message Source of the message, read once
+       *@return the signature
+       */
+      signatureABS<Element> Sign(const LPVerificationKey<Element>& vk,
+                                 const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                 const vector<string>& attributeList,
+                                 ABSMessageSource& message);
+      /**
+       *@brief Method for signing a message for registered attributes. The
+       *signature carries their ids, so Verify reads its syndromes straight
+       *from the registry table
+       *@param vk Verification key
+       *@param attributesKey Attribute key of the signer
+       *@param attributes Ids of the attributes of the key
+       *@param message Message to be signed
+       *@return the signature
+       */
+      signatureABS<Element> Sign(const LPVerificationKey<Element>& vk,
+                                 const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                 const vector<AttributeId>& attributes,
+                                 const string& message);
+      /**
+       *@brief Method for signing a message read from a source for registered
+       *attributes
+       *@param vk Verification key
+       *@param attributesKey Attribute key of the signer
+       *@param attributes Ids of the attributes of the key
+       *@param message Source of the message, read once
+       *@return the signature
+       */
+      signatureABS<Element> Sign(const LPVerificationKey<Element>& vk,
+                                 const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                 const vector<AttributeId>& attributes,
+                                 ABSMessageSource& message);
+      /**
+       *@brief Method for signing into an existing signature with caller owned
+       *scratch space. Once both have been used with this context, the call
+       *does not allocate. The signing pool is not used
+       *@param vk Verification key
+       *@param attributesKey Attribute key of the signer
+       *@param attributeList Attributes of the key
+       *@param message Source of the message, read once
+       *@param workspace Scratch space, used by one call at a time
+       *@param signature Signature overwritten with the result - Output
+       */
+      void Sign(const LPVerificationKey<Element>& vk,
+                const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                const vector<string>& attributeList,
+                ABSMessageSource& message,
+                SignWorkspace<Element>* workspace,
+                signatureABS<Element>* signature);
+      /**
+       *@brief Method for signing many messages with one attribute key using
+       *every core
+       *@param vk Verification key
+       *@param attributesKey Attribute key of the signer
+       *@param attributeList Attributes of the key
+       *@param messages Messages to be signed
+       *@return one signature per message, in order
+       */
+      vector<signatureABS<Element>> SignBatch(const LPVerificationKey<Element>& vk,
+                                     const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                     const vector<string>& attributeList,
+                                     const vector<string>& messages);
+      bool Verify(const LPVerificationKey<Element>& vk,
+                  const signatureABS<Element>& signature,
+                  const string& message);
+      /**
+       *@brief Method for verifying a signature of a message read from a
+       *source, hashed in chunks. When every attribute of the signature is
+       *registered under its hash mode, and the subset sum tables are
+       *disabled, the syndromes come from the attribute registry
+       *@param vk Verification key
+       *@param signature Signature to be checked
+       *@param message Source of the message, read once
+       *@return true if the signature is valid
+       */
+      bool Verify(const LPVerificationKey<Element>& vk,
+                  const signatureABS<Element>& signature,
+                  ABSMessageSource& message);
+      /**
+       *@brief Method for verifying with caller owned scratch space, which
+       *also keeps the syndromes of the last attribute set. Once it has been
+       *used with this context and the same attributes, the call does not
+       *allocate
+       *@param vk Verification key
+       *@param signature Signature to be checked
+       *@param message Source of the message, read once
+       *@param workspace Scratch space, used by one call at a time
+       *@return true if the signature is valid
+       */
       bool Verify(const LPVerificationKey<Element>& vk,
-                  signatureABS signature,
-                  string message);
+                  const signatureABS<Element>& signature,
+                  ABSMessageSource& message,
+                  VerifyWorkspace<Element>* workspace);
+      /**
+       *@brief Method for verifying many signatures under one verification key
+       *using every core
+       *@param vk Verification key
+       *@param batch Pairs of signature and signed message
+       *@return one bit per pair, set when the signature is valid
+       */
+      vector<bool> VerifyBatch(const LPVerificationKey<Element>& vk,
+                               const vector<std::pair<signatureABS<Element>, string>>& batch);
+      /**
+       *@brief Offline half of Sign, which does not depend on the message or
+       *the signer: samples the y vector and computes A*y
+       *@param vk Verification key
+       *@return the nonce, to be used by a single SignOnline call
+       */
+      shared_ptr<SignatureNonce<Element>> SignOffline(const LPVerificationKey<Element>& vk);
+      /**
+       *@brief Online half of Sign: hashes the message into the tag and adds
+       *the attribute keys it selects
+       *@param attributesKey Attribute key of the signer
+       *@param nonce Nonce from SignOffline, consumed by the call
+       *@param attributeList Attributes of the key
+       *@param message Source of the message, read once
+       *@return the signature
+       */
+      signatureABS<Element> SignOnline(const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                       SignatureNonce<Element>* nonce,
+                                       const vector<string>& attributeList,
+                                       ABSMessageSource& message);
+      /**
+       *@brief First half of Verify: sums the syndromes of the signature
+       *attributes selected by its tag. It does not need the message
+       *@param signature Signature to be checked
+       *@return the syndrome sum, to be passed to VerifyWithSyndrome
+       */
+      Element SignatureSyndrome(const signatureABS<Element>& signature);
+      /**
+       *@brief Second half of Verify: checks the tag of the signature against
+       *its lattice point, its syndrome sum and the message
+       *@param vk Verification key
+       *@param signature Signature to be checked
+       *@param syndrome Syndrome sum from SignatureSyndrome
+       *@param message Source of the message, read once
+       *@return true if the signature is valid
+       */
+      bool VerifyWithSyndrome(const LPVerificationKey<Element>& vk,
+                              const signatureABS<Element>& signature,
+                              const Element& syndrome,
+                              ABSMessageSource& message);
+      /**
+       *@brief Method for preparing a verification key for fast products. Sign
+       *and Verify use it for this key from then on
+       *@param vk Verification key to be prepared
+       *@return false if the ring moduli are too large, in which case the
+       *generic product keeps being used
+       */
+      bool PrepareVerificationKey(const LPVerificationKey<Element>& vk);
+      /**
+       *@brief Method for encoding a signature in the compact wire format
+       *@param signature Signature to be encoded
+       *@return the encoded bytes
+       */
+      vector<uint8_t> SerializeSignature(const signatureABS<Element>& signature) const;
+      /**
+       *@brief Method for decoding a signature in the compact wire format
+       *@param data Encoded bytes
+       *@param size Number of encoded bytes
+       *@return the signature, with its lattice point in EVALUATION format
+       */
+      signatureABS<Element> DeserializeSignature(const uint8_t* data, size_t size) const;
+      /**
+       *@brief Method for accessing the scheme parameters
+       *@return the parameters, or nullptr before a GPV context is generated
+       */
+      shared_ptr<LPSignatureParameters<Element>> GetParams() const { return m_params; }
+      /**
+       *@brief Method for reading the per phase timings of every thread. The
+       *counters are process wide, shared by all the contexts
+       *@return the snapshot, with no calls when built without WITH_ABS_STATS
+       */
+      static ABSStatsSnapshot GetStats() { return absStatsSnapshot(); }
+      /**
+       *@brief Method for zeroing the per phase timings
+       */
+      static void ResetStats() { absStatsReset(); }
+      /**
+       *@brief Method for serving the coefficient storage of the ring elements
+       *of this context, and the 64 bit sample vectors of the same length,
+       *from the process wide slab allocator (see absslab.h)
+       *@param config Huge pages, reserved range and thread caches. The block
+       *sizes of the ring are added to the ones it lists
+       *@return false if the allocator could not be enabled, or the build has
+       *no WITH_ABS_SLAB
+       */
+      bool EnableSlabAllocator(ABSSlabConfig config = ABSSlabConfig()) const;
+      /**
+       *@brief Method for accessing the attribute syndrome cache shared by
+       *Extract and Verify
+       *@return the cache, or nullptr before a GPV context is generated
+       */
+      shared_ptr<AttributeSyndromeCache<Element>> GetSyndromeCache() const {
+        return m_syndromeCache;
+      }
+      /**
+       *@brief Method for bounding the number of cached attributes, 0 disables
+       *the cache
+       *@param capacity Maximum number of attributes kept in the cache
+       */
+      void SetSyndromeCacheCapacity(size_t capacity);
+      /**
+       *@brief Method for setting how many workers sample the preimages of an
+       *Extract call
+       *@param numThreads Number of workers, 0 uses every available core
+       */
+      void SetExtractThreads(usint numThreads) { m_extractThreads = numThreads; }
+      /**
+       *@brief Method for setting how many workers share the messages of a
+       *SignBatch or VerifyBatch call
+       *@param numThreads Number of workers, 0 uses every available core
+       */
+      void SetBatchThreads(usint numThreads) { m_batchThreads = numThreads; }
+      /**
+       *@brief Method for setting how many workers share the work inside a
+       *single Sign or Verify call: the column products of A*z, the tag bits
+       *of the attribute syndromes and the serialization of the tag input.
+       *Worth it for ring sizes 2048 and 4096, where one call is long enough
+       *to split. The batch calls keep one worker per message
+       *@param numThreads Number of workers, 1 disables it, 0 uses every
+       *available core
+       */
+      void SetIntraOpThreads(usint numThreads) { m_intraOpThreads = numThreads; }
+      /**
+       *@brief Method for choosing how new signatures serialize the ring element
+       *hashed into their tag. Verify always uses the encoding stored in the
+       *signature
+       *@param encoding Tag encoding of the signatures made from now on
+       */
+      void SetTagEncoding(TagEncoding encoding) { m_tagEncoding = encoding; }
+      /**
+       *@brief Method for choosing how attributes are hashed into their public
+       *syndrome. Keys must be extracted again after a change, Verify always
+       *uses the mode stored in the signature
+       *@param hashMode Attribute hash of the keys and signatures made from now on
+       */
+      void SetAttributeHashMode(AttributeHashMode hashMode);
+      /**
+       *@brief Method for choosing the attributes interned by the registry,
+       *which is built again for the current parameters. The universe starts as
+       *attributesList
+       *@param attributes Attributes, given ids 0, 1, ... in order
+       */
+      void SetAttributeUniverse(const vector<string>& attributes);
+      /**
+       *@brief Method for accessing the attribute registry, built with the
+       *context, which holds the syndromes of every attribute of the universe
+       *@return the registry, or nullptr before a GPV context is generated
+       */
+      shared_ptr<const AttributeRegistry<Element>> GetAttributeRegistry() const {
+        return m_registry;
+      }
+      /**
+       *@brief Method for looking up the registry ids of attributes, once, for
+       *the Extract and Sign calls taking ids
+       *@param attributes Attribute names
+       *@return their ids, in the same order
+       */
+      vector<AttributeId> AttributeIds(const vector<string>& attributes) const;
+      /**
+       *@brief Method for adding the attribute keys in Sign and the syndromes in
+       *Verify through subset sum tables, with one addition per window of the
+       *tag. The table of a key or attribute set is built on its first use and
+       *cached. A key table holds about 32 / windowBits * (2^windowBits - 1)
+       *key matrices, 120 for 4 bit windows
+       *@param windowBits Window width, from 1 to 8 bits, 0 disables the tables
+       *@param keyTables Number of signer keys whose table is kept
+       *@param syndromeTables Number of attribute sets whose table is kept
+       */
+      void SetSubsetSumWindow(usint windowBits, size_t keyTables = 4, size_t syndromeTables = 64);
 
     private:
       // The signature scheme used
       shared_ptr<LPSignatureScheme<Element>> m_scheme;
       // Parameters related to the scheme
       shared_ptr<LPSignatureParameters<Element>> m_params;
+      // Syndromes of the attributes already seen, valid for m_params only
+      shared_ptr<AttributeSyndromeCache<Element>> m_syndromeCache;
+      // Capacity used when the cache is (re)created
+      size_t m_syndromeCacheCapacity = 1024;
+      // Workers used to sample the attribute keys, 0 means all cores
+      usint m_extractThreads = 0;
+      // Workers used by the batch calls, 0 means all cores
+      usint m_batchThreads = 0;
+      // Workers inside a single Sign or Verify call, 0 means all cores
+      usint m_intraOpThreads = 1;
+      // Tag encoding of new signatures
+      TagEncoding m_tagEncoding = TAG_ENCODING_BINARY;
+      // Attribute hash of new keys and signatures
+      AttributeHashMode m_hashMode = ATTRIBUTE_HASH_SHAKE128;
+      // Precomputed perturbations for a single sign key, if enabled
+      shared_ptr<PerturbationPool<Element>> m_perturbationPool;
+      // Precomputed signature nonces for a single verification key, if enabled
+      shared_ptr<SigningPool<Element>> m_signingPool;
+      // Prepared verification key, if enabled
+      shared_ptr<PreparedVerificationKey<Element>> m_preparedKey;
+      // Subset sum tables of signer keys and of attribute sets, if enabled
+      shared_ptr<SubsetSumTableCache<Element>> m_keyTables;
+      shared_ptr<SubsetSumTableCache<Element>> m_syndromeTables;
+      // Attributes interned by the registry, and the registry itself, valid
+      // for m_params and m_hashMode only
+      vector<string> m_attributeNames =
+          vector<string>(std::begin(attributesList), std::end(attributesList));
+      shared_ptr<const AttributeRegistry<Element>> m_registry;
+
+      // Builds the registry again for the current parameters and hash mode
+      void ResetAttributeRegistry();
+
+      // Returns the registry, throwing config_error when there is none
+      const AttributeRegistry<Element>& Registry() const;
+
+      // Returns the registry if Verify can take the syndromes of the
+      // signature from it, or nullptr
+      const AttributeRegistry<Element>* RegistryFor(const signatureABS<Element>& signature) const;
+
+      // Drops the subset sum tables, which only fit the current parameters
+      void ResetSubsetSumTables();
+
+      // Returns the subset sum table of a key, building it if needed, or
+      // nullptr when the tables are disabled
+      shared_ptr<const SubsetSumTable<Element>> KeyTableFor(
+          const vector<shared_ptr<Matrix<Element>>>& attributesKey);
+
+      // Returns the prepared key if it was prepared from vk, or nullptr
+      const PreparedVerificationKey<Element>* PreparedKeyFor(
+          const GPVVerificationKey<Element>& vk) const {
+        if (m_preparedKey != nullptr && m_preparedKey->IsBoundTo(vk))
+          return m_preparedKey.get();
+        return nullptr;
+      }
   };
 
+  /**
+   *@brief RNS version of the context setup, the modulus of bitwidth bits is
+   * built as a product of NTT-friendly primes that fit a machine word
+   */
+  template <>
+  void SignatureContext<DCRTPoly>::GenerateGPVContext(usint ringsize,
+                                                      usint bitwidth,
+                                                      usint base);
+
 }  // namespace lbcrypto
 
 #endif
@@ -0,0 +1,88 @@
+// @file signingpool.h - Pool of precomputed nonces for the online ABS signing
+
+#ifndef SIGNATURE_SIGNINGPOOL_H
+#define SIGNATURE_SIGNINGPOOL_H
+
+#include <memory>
+
+#include "gpv.h"
+#include "abs.h"
+#include "precomputepool.h"
+
+namespace lbcrypto {
+/**
+ *@brief Bounded pool of signature nonces made with signOffline by background
+ *threads for a single verification key and tag encoding. Each nonce holds a
+ *gaussian y with the hash of A*y, so an online signature only hashes the
+ *message and adds the attribute keys. Every nonce is handed out only once.
+ *@tparam Element ring element
+ */
+template <class Element>
+class SigningPool {
+ public:
+  /**
+   *@brief Constructor, starts refilling the pool right away
+   *@param params Parameters used for the scheme
+   *@param verificationKey Verification key the secrets A*y are computed with
+   *@param encoding Tag encoding of the signatures made with the nonces
+   *@param prepared Prepared version of the verification key, or nullptr
+   *@param config Watermarks, number of workers and refill rate
+   */
+  SigningPool(shared_ptr<GPVSignatureParameters<Element>> params,
+              const GPVVerificationKey<Element>& verificationKey,
+              TagEncoding encoding,
+              shared_ptr<const PreparedVerificationKey<Element>> prepared = nullptr,
+              const PrecomputePoolConfig& config = PrecomputePoolConfig());
+
+  /**
+   *@brief Method for removing a nonce from the pool. If the pool is empty the
+   *nonce is made inline and a starvation is counted
+   *@return a nonce never handed out before
+   */
+  shared_ptr<SignatureNonce<Element>> Take() { return m_pool.Take(); }
+
+  /**
+   *@brief Method for checking if the pool makes nonces for a given
+   *verification key and encoding
+   *@param verificationKey Verification key to be checked
+   *@param encoding Tag encoding to be checked
+   *@return true if both keys share the same public matrix and the encodings
+   *match
+   */
+  bool IsBoundTo(const GPVVerificationKey<Element>& verificationKey,
+                 TagEncoding encoding) const {
+    return &verificationKey.GetVerificationKey() == &m_verificationKey.GetVerificationKey() &&
+           encoding == m_encoding;
+  }
+
+  /**
+   *@brief Method for accessing the underlying pool, to tune or observe it
+   *@return the pool of nonces
+   */
+  PrecomputePool<shared_ptr<SignatureNonce<Element>>>& GetPool() { return m_pool; }
+
+  /**
+   *@brief Method for reading the pool counters
+   *@return a snapshot of the pool counters
+   */
+  PrecomputePoolStats GetStats() const { return m_pool.GetStats(); }
+
+ private:
+  // Builds a producer making nonces with the pool keys
+  typename PrecomputePool<shared_ptr<SignatureNonce<Element>>>::Producer MakeProducer();
+
+  // Parameters used in the sampling
+  shared_ptr<GPVSignatureParameters<Element>> m_params;
+  // Verification key the secrets are computed with
+  GPVVerificationKey<Element> m_verificationKey;
+  // Tag encoding the secrets are hashed for
+  TagEncoding m_encoding;
+  // Prepared verification key, if any
+  shared_ptr<const PreparedVerificationKey<Element>> m_prepared;
+  // Pool of nonces, must be the last member so the workers are stopped
+  // before the rest of the object is destroyed
+  PrecomputePool<shared_ptr<SignatureNonce<Element>>> m_pool;
+};
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef __SIMDKERNELS_H_
+#define __SIMDKERNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Element-wise kernels on arrays of coefficients reduced modulo a word sized
+// q, with AVX2 and AVX-512 versions selected at runtime from the CPU features.
+// Every level computes exactly the same words as the scalar code.
+
+enum SimdLevel {
+    SIMD_SCALAR = 0,
+    SIMD_AVX2 = 1,
+    SIMD_AVX512 = 2
+};
+
+// Best level supported by the CPU
+SimdLevel detectSimdLevel();
+
+// Level used by the kernels, the detected one unless it was lowered
+SimdLevel getSimdLevel();
+
+// Changes the level used by the kernels, capped to what the CPU supports.
+// Returns the level actually set
+SimdLevel setSimdLevel(SimdLevel level);
+
+const char *simdLevelName(SimdLevel level);
+
+// a[i] = (a[i] + b[i]) mod q, for inputs below q < 2^62
+void vectorModAdd(uint64_t *a, const uint64_t *b, size_t n, uint64_t q);
+
+// a[i] = (a[i] - b[i]) mod q, for inputs below q < 2^62
+void vectorModSub(uint64_t *a, const uint64_t *b, size_t n, uint64_t q);
+
+// sum[i] += x[i] * a[i] modulo q, for x[i], a[i] < q < 2^62, where aShoup[i]
+// is floor(a[i] * 2^64 / q). The sums are kept lazily reduced in [0, 2q).
+// Moduli below 2^32 use 32 bit Shoup products, which are the ones vectorized
+void vectorShoupMulAcc(uint64_t *sum, const uint64_t *x, const uint64_t *a,
+                       const uint64_t *aShoup, size_t n, uint64_t q);
+
+#endif // __SIMDKERNELS_H_
@@ -0,0 +1,165 @@
+#ifndef __SPSCQUEUE_H_
+#define __SPSCQUEUE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lbcrypto {
+
+/**
+ * @brief Counters of a SpscQueue. The producer side ones are only updated by
+ * the producer and the consumer side ones by the consumer, so they should be
+ * read once both threads are done
+ */
+struct SpscQueueStats {
+  // Items pushed
+  uint64_t pushed = 0;
+  // Sum of the number of queued items seen right after each push, divided by
+  // pushed it gives the mean occupancy
+  uint64_t occupancySum = 0;
+  // Time the producer waited for room
+  uint64_t blockedNs = 0;
+  // Time the consumer waited for an item
+  uint64_t starvedNs = 0;
+};
+
+/**
+ * @brief Bounded lock-free queue between exactly one producer thread and one
+ * consumer thread.
+ *
+ * The items live in a ring whose size is a power of two. The producer only
+ * writes the tail and the consumer only writes the head, so each side needs
+ * a single release store per item. The blocking calls spin for a while and
+ * then yield, which suits stages that take microseconds per item. The
+ * producer closes the queue once it has no more items, after which Pop drains
+ * what is left and then fails.
+ */
+template <class T>
+class SpscQueue {
+ public:
+  /**
+   *@brief Constructor
+   *@param capacity Maximum number of queued items, rounded up to a power of two
+   */
+  explicit SpscQueue(size_t capacity) : m_head(0), m_tail(0), m_closed(false) {
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    m_slots.resize(size);
+    m_mask = size - 1;
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  /**
+   *@brief Queues an item if there is room. Producer only
+   *@param item Item, moved from only on success
+   *@return false if the queue is full
+   */
+  bool TryPush(T& item) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    size_t head = m_head.load(std::memory_order_acquire);
+    if (tail - head > m_mask) return false;
+
+    m_slots[tail & m_mask] = std::move(item);
+    m_tail.store(tail + 1, std::memory_order_release);
+
+    m_stats.pushed++;
+    m_stats.occupancySum += tail + 1 - head;
+    return true;
+  }
+
+  /**
+   *@brief Queues an item, waiting for room. Producer only
+   *@param item Item to be queued
+   */
+  void Push(T item) {
+    if (TryPush(item)) return;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned spins = 0; !TryPush(item); spins++) Backoff(spins);
+    m_stats.blockedNs += Elapsed(start);
+  }
+
+  /**
+   *@brief Takes the oldest item if there is one. Consumer only
+   *@param item Output, the item
+   *@return false if the queue is empty
+   */
+  bool TryPop(T* item) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+    *item = std::move(m_slots[head & m_mask]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   *@brief Takes the oldest item, waiting for one. Consumer only
+   *@param item Output, the item
+   *@return false once the queue is closed and empty
+   */
+  bool Pop(T* item) {
+    if (TryPop(item)) return true;
+
+    auto start = std::chrono::steady_clock::now();
+    bool got = false;
+    for (unsigned spins = 0;; spins++) {
+      // Read the flag before trying again, so items pushed before Close are
+      // never missed
+      bool closed = m_closed.load(std::memory_order_acquire);
+      if (TryPop(item)) {
+        got = true;
+        break;
+      }
+      if (closed) break;
+      Backoff(spins);
+    }
+    m_stats.starvedNs += Elapsed(start);
+    return got;
+  }
+
+  /**
+   *@brief Marks the end of the items. Producer only
+   */
+  void Close() { m_closed.store(true, std::memory_order_release); }
+
+  /**
+   *@brief Method for accessing the maximum number of queued items
+   */
+  size_t GetCapacity() const { return m_slots.size(); }
+
+  /**
+   *@brief Method for accessing the counters, see SpscQueueStats
+   */
+  const SpscQueueStats& GetStats() const { return m_stats; }
+
+ private:
+  // Spins at first, then gives the core away
+  static void Backoff(unsigned spins) {
+    if (spins >= 64) std::this_thread::yield();
+  }
+
+  static uint64_t Elapsed(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+  }
+
+  std::vector<T> m_slots;
+  size_t m_mask;
+  // Next slot to pop and next slot to push, on separate cache lines so the
+  // two threads do not share one
+  alignas(64) std::atomic<size_t> m_head;
+  alignas(64) std::atomic<size_t> m_tail;
+  std::atomic<bool> m_closed;
+  SpscQueueStats m_stats;
+};
+
+}  // namespace lbcrypto
+
+#endif  // __SPSCQUEUE_H_
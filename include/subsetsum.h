@@ -0,0 +1,111 @@
+#ifndef __SUBSETSUM_H_
+#define __SUBSETSUM_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "lattice/backend.h"
+#include "math/matrix.h"
+
+using namespace lbcrypto;
+
+// Largest window width accepted by SubsetSumTable
+const usint SUBSET_SUM_MAX_WINDOW_BITS = 8;
+
+// Precomputed subset sums of the 32 values selected by the bits of a tag.
+//
+// Sign adds the attribute keys and verify adds the attribute syndromes whose
+// bit is set in the 32 bit tag. The table splits the tag in windows of
+// windowBits bits and stores, for each window, the sum of every non empty
+// subset of its values, so a tag is accumulated with one addition per window
+// (8 for 4 bit windows) instead of one per set bit (16 on average, up to 32).
+// The table holds about 32 / windowBits * (2^windowBits - 1) sums, and the
+// results are exactly the ones of the bit by bit accumulation.
+template <class Element>
+class SubsetSumTable {
+    public:
+        // Table of the attribute keys of a user. Only weak references to the
+        // keys are kept, to recognize them later
+        SubsetSumTable(const vector<shared_ptr<Matrix<Element>>> &attributesKey, usint windowBits);
+
+        // Table of the 32 syndromes of an attribute set
+        SubsetSumTable(const Matrix<Element> &syndromeMatrix, usint windowBits);
+
+        // Adds to sum the keys (or syndromes) selected by the bits of h
+        void accumulate(uint32_t h, Matrix<Element> *sum) const;
+        void accumulate(uint32_t h, Element *sum) const;
+
+        // True if the table was built from these very key matrices
+        bool isBuiltFrom(const vector<shared_ptr<Matrix<Element>>> &attributesKey) const;
+
+        usint getWindowBits() const {return this->windowBits;}
+        size_t getEntryCount() const {return this->entries.size() / this->width;}
+
+        // Number of sums stored by a table with the given window width
+        static size_t entriesFor(usint windowBits);
+
+    private:
+        // Fills the table from the values selected by each bit, flattened in
+        // row major order
+        void build(const vector<vector<Element>> &values);
+
+        // Index of the first element of a window entry
+        size_t entryOffset(usint window, uint32_t subset) const;
+
+        usint windowBits;
+        size_t rows;
+        size_t cols;
+        // Number of ring elements in each value
+        size_t width;
+        vector<Element> entries;
+        // Keys the table was built from, empty for syndrome tables
+        vector<std::weak_ptr<Matrix<Element>>> sources;
+};
+
+// Bounded, thread safe cache of subset sum tables, used for the key tables of
+// signers and the syndrome tables of attribute sets. All the tables built by
+// the users of a cache share its window width. The least recently used table
+// is evicted once the capacity is reached.
+template <class Element>
+class SubsetSumTableCache {
+    public:
+        explicit SubsetSumTableCache(usint windowBits = 4, size_t capacity = 64)
+            : windowBits(windowBits), capacity(capacity) {}
+
+        // Returns the cached table for the key, or nullptr on a miss
+        shared_ptr<const SubsetSumTable<Element>> lookup(const string &key);
+
+        // Stores a table, evicting old entries if needed
+        void insert(const string &key, shared_ptr<const SubsetSumTable<Element>> table);
+
+        // Drops every table
+        void clear();
+
+        usint getWindowBits() const {return this->windowBits;}
+
+        size_t getCapacity() const;
+        void setCapacity(size_t capacity);
+        size_t getSize() const;
+
+    private:
+        typedef std::list<std::pair<string, shared_ptr<const SubsetSumTable<Element>>>> EntryList;
+        typedef typename EntryList::iterator EntryIterator;
+
+        // Removes entries until the cache fits its capacity, lock must be held
+        void shrink();
+
+        const usint windowBits;
+        size_t capacity;
+        // Entries ordered from the most to the least recently used
+        EntryList entries;
+        std::unordered_map<string, EntryIterator> index;
+        mutable std::mutex lock;
+};
+
+#endif // __SUBSETSUM_H_
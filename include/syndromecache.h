@@ -0,0 +1,67 @@
+#ifndef __SYNDROMECACHE_H_
+#define __SYNDROMECACHE_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "lattice/backend.h"
+
+using namespace lbcrypto;
+
+// Bounded, thread safe cache of the public syndrome of single attributes.
+//
+// Each entry holds the 32 polynomials (already in EVALUATION format) that
+// attributeHashGenerator derives from one attribute string, so a cached
+// attribute is added to the syndrome matrix without hashing, encoding or NTTs.
+// The least recently used attribute is evicted once the capacity is reached.
+template <class Element>
+class AttributeSyndromeCache {
+    public:
+        typedef vector<Element> SyndromeRow;
+
+        explicit AttributeSyndromeCache(size_t capacity = 1024)
+            : capacity(capacity), hits(0), misses(0), evictions(0) {}
+
+        // Returns the cached row for the attribute, or nullptr on a miss
+        shared_ptr<const SyndromeRow> lookup(const string &attribute);
+
+        // Stores the row of an attribute, evicting old entries if needed
+        void insert(const string &attribute, shared_ptr<const SyndromeRow> row);
+
+        // Drops every entry (counters are kept)
+        void clear();
+
+        size_t getCapacity() const;
+        void setCapacity(size_t capacity);
+        size_t getSize() const;
+
+        uint64_t getHits() const {return this->hits.load(std::memory_order_relaxed);}
+        uint64_t getMisses() const {return this->misses.load(std::memory_order_relaxed);}
+        uint64_t getEvictions() const {return this->evictions.load(std::memory_order_relaxed);}
+        void resetCounters();
+
+    private:
+        typedef std::list<std::pair<string, shared_ptr<const SyndromeRow>>> EntryList;
+        typedef typename EntryList::iterator EntryIterator;
+
+        // Removes entries until the cache fits its capacity, lock must be held
+        void shrink();
+
+        size_t capacity;
+        // Entries ordered from the most to the least recently used
+        EntryList entries;
+        std::unordered_map<string, EntryIterator> index;
+        mutable std::mutex lock;
+
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> evictions;
+};
+
+#endif // __SYNDROMECACHE_H_
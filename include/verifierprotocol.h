@@ -0,0 +1,98 @@
+#ifndef __VERIFIERPROTOCOL_H_
+#define __VERIFIERPROTOCOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Framing of the verification daemon, spoken over a stream socket. Every
+// message is a frame: its payload length (4 bytes, big-endian) followed by
+// the payload. Request payloads are
+//
+//   type (1 byte) | request id (8 bytes, big-endian)
+//   VERIFY only: signature length (4 bytes, big-endian) | signature | message
+//
+// where the signature is in the compact wire format of abswire.h and the
+// message takes the rest of the frame. Response payloads are
+//
+//   type (1 byte) | request id (8 bytes, big-endian)
+//   VERIFY: status (1 byte)
+//   STATS: the daemon statistics as a JSON object
+//
+// A connection may have any number of requests in flight, and responses may
+// come back in another order than the requests.
+
+// Largest payload accepted, larger frames close the connection
+const size_t VERIFIER_MAX_FRAME = 16 * 1024 * 1024;
+
+enum VerifierMessageType {
+    VERIFIER_VERIFY = 1,
+    VERIFIER_STATS = 2
+};
+
+enum VerifierStatus {
+    VERIFIER_VALID = 0,
+    VERIFIER_INVALID = 1,
+    // The request or its signature could not be decoded
+    VERIFIER_MALFORMED = 2,
+    // The daemon queues were full and the request was dropped
+    VERIFIER_OVERLOADED = 3
+};
+
+// Request parsed from a payload. The signature and the message point into
+// the payload, which must outlive the request
+struct VerifierRequest {
+    VerifierMessageType type;
+    uint64_t id;
+    const uint8_t *signature;
+    size_t signatureSize;
+    const uint8_t *message;
+    size_t messageSize;
+};
+
+struct VerifierResponse {
+    VerifierMessageType type;
+    uint64_t id;
+    VerifierStatus status;
+    std::string stats;
+};
+
+// Append a whole frame to out
+void appendVerifyRequest(uint64_t id, const std::vector<uint8_t> &signature, const std::string &message,
+                         std::vector<uint8_t> *out);
+void appendStatsRequest(uint64_t id, std::vector<uint8_t> *out);
+void appendVerifyResponse(uint64_t id, VerifierStatus status, std::vector<uint8_t> *out);
+void appendStatsResponse(uint64_t id, const std::string &stats, std::vector<uint8_t> *out);
+
+// Parse a payload, throwing deserialize_error if it is malformed
+void parseVerifierRequest(const uint8_t *payload, size_t size, VerifierRequest *request);
+void parseVerifierResponse(const uint8_t *payload, size_t size, VerifierResponse *response);
+
+// Incoming bytes of a connection, split in frames
+class VerifierFrameReader {
+    public:
+        explicit VerifierFrameReader(int fd) : fd(fd), start(0) {}
+
+        // Waits for more bytes and keeps them, returning false once the peer
+        // closed the connection. Throws deserialize_error on read errors
+        bool fill();
+
+        // Points payload to the next complete frame and returns true, or
+        // returns false when the buffered bytes hold no complete frame. The
+        // payload stays valid until the next fill. Throws deserialize_error
+        // on frames larger than VERIFIER_MAX_FRAME
+        bool next(const uint8_t **payload, size_t *size);
+
+    private:
+        int fd;
+        std::vector<uint8_t> buffer;
+        // Offset of the first byte not handed out yet
+        size_t start;
+};
+
+// Writes every byte to a socket, retrying on short writes and without raising
+// SIGPIPE. Returns false if the connection is gone
+bool writeVerifierFrames(int fd, const std::vector<uint8_t> &frames);
+
+#endif // __VERIFIERPROTOCOL_H_
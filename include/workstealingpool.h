@@ -0,0 +1,140 @@
+#ifndef __WORKSTEALINGPOOL_H_
+#define __WORKSTEALINGPOOL_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "utils/inttypes.h"
+
+namespace lbcrypto {
+
+/**
+ * @brief Tuning knobs of a WorkStealingPool
+ */
+struct WorkStealingPoolConfig {
+  // Number of worker threads, 0 uses every available core
+  usint workers = 0;
+  // Maximum number of tasks waiting to run, over all the workers
+  size_t capacity = 1024;
+};
+
+/**
+ * @brief Counters describing the state of a WorkStealingPool
+ */
+struct WorkStealingPoolStats {
+  // Tasks waiting to run
+  size_t pending = 0;
+  // Largest number of tasks ever waiting at once
+  size_t maxPending = 0;
+  // Tasks accepted by Submit and TrySubmit
+  uint64_t submitted = 0;
+  // Tasks that finished running
+  uint64_t executed = 0;
+  // Tasks run by another worker than the one they were queued on
+  uint64_t stolen = 0;
+  // Tasks refused by TrySubmit because the pool was full
+  uint64_t rejected = 0;
+  // Submit calls that had to wait for room in the pool
+  uint64_t waits = 0;
+};
+
+/**
+ * @brief Bounded thread pool where idle workers steal from busy ones.
+ *
+ * Each worker owns a queue. Tasks submitted from outside the pool are spread
+ * over the queues in turn, tasks submitted by a task go to the queue of its
+ * worker. A worker runs its own tasks newest first and, once its queue is
+ * empty, steals the oldest task of another queue. The total number of
+ * waiting tasks is bounded: Submit blocks and TrySubmit fails while the pool
+ * is full, which pushes back on the producers. Tasks must not throw.
+ */
+class WorkStealingPool {
+ public:
+  typedef std::function<void()> Task;
+
+  /**
+   *@brief Constructor, starts the workers
+   *@param config Number of workers and capacity
+   */
+  explicit WorkStealingPool(
+      const WorkStealingPoolConfig& config = WorkStealingPoolConfig());
+
+  /**
+   *@brief Destructor, runs the tasks still waiting and joins the workers
+   */
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /**
+   *@brief Queues a task, waiting for room if the pool is full
+   *@param task Task to be run by a worker
+   */
+  void Submit(Task task);
+
+  /**
+   *@brief Queues a task unless the pool is full
+   *@param task Task to be run by a worker
+   *@return false if the task was refused
+   */
+  bool TrySubmit(Task task);
+
+  /**
+   *@brief Returns the number of workers
+   */
+  usint GetWorkers() const { return m_workers.size(); }
+
+  /**
+   *@brief Returns the maximum number of waiting tasks
+   */
+  size_t GetCapacity() const { return m_capacity; }
+
+  /**
+   *@brief Returns a snapshot of the pool counters
+   */
+  WorkStealingPoolStats GetStats() const;
+
+ private:
+  struct WorkerQueue {
+    std::mutex lock;
+    std::deque<Task> tasks;
+  };
+
+  // Queues a task once room was reserved for it
+  void Push(Task task);
+
+  // Takes the next task for a worker, from its own queue or another one
+  bool Pop(usint worker, Task* task);
+
+  // Worker loop
+  void Run(usint worker);
+
+  size_t m_capacity;
+  vector<std::unique_ptr<WorkerQueue>> m_queues;
+  vector<std::thread> m_workers;
+
+  // Guards the counters below and the stop flag
+  mutable std::mutex m_lock;
+  // Signaled when a task is queued or the pool stops
+  std::condition_variable m_wakeup;
+  // Signaled when a task leaves the queues
+  std::condition_variable m_room;
+  bool m_stop;
+  // Tasks in the queues, not yet taken by a worker
+  size_t m_queued;
+  WorkStealingPoolStats m_stats;
+
+  // Queue of the next task submitted from outside the pool
+  std::atomic<size_t> m_nextQueue;
+};
+
+}  // namespace lbcrypto
+
+#endif  // __WORKSTEALINGPOOL_H_
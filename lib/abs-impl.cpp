@@ -0,0 +1,97 @@
+// Forward definition of the ABS functions for each supported ring element
+
+#include "abs.cpp"
+#include "abs.h"
+
+#define ABS_INSTANTIATE(Element)                                                              \
+    template class signatureABS<Element>;                                                     \
+    template shared_ptr<const typename AttributeSyndromeCache<Element>::SyndromeRow>          \
+    attributeSyndrome<Element>(                                                               \
+        const string &, shared_ptr<GPVSignatureParameters<Element>>, AttributeHashMode);      \
+    template void attributeHashGenerator<Element>(                                            \
+        const vector<string> &, shared_ptr<GPVSignatureParameters<Element>>, Matrix<Element> *,\
+        AttributeSyndromeCache<Element> *, AttributeHashMode);                                \
+    template vector<shared_ptr<Matrix<Element>>> extract<Element>(                            \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVSignKey<Element> &,             \
+        const GPVVerificationKey<Element> &, const vector<string> &,                          \
+        AttributeSyndromeCache<Element> *, usint, PerturbationPool<Element> *,                \
+        AttributeHashMode);                                                                   \
+    template vector<shared_ptr<Matrix<Element>>> extract<Element>(                            \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVSignKey<Element> &,             \
+        const GPVVerificationKey<Element> &, const AttributeRegistry<Element> &,              \
+        const vector<AttributeId> &, usint, PerturbationPool<Element> *);                     \
+    template signatureABS<Element> sign<Element>(                                             \
+        shared_ptr<GPVSignatureParameters<Element>>,                                          \
+        const vector<shared_ptr<Matrix<Element>>> &, const GPVVerificationKey<Element> &,     \
+        const string &, const vector<string> &, TagEncoding,                                  \
+        AttributeHashMode, const PreparedVerificationKey<Element> *,                          \
+        const SubsetSumTable<Element> *);                                                     \
+    template shared_ptr<SignatureNonce<Element>> signOffline<Element>(                        \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVVerificationKey<Element> &,     \
+        TagEncoding, const PreparedVerificationKey<Element> *);                               \
+    template signatureABS<Element> signOnline<Element>(                                       \
+        shared_ptr<GPVSignatureParameters<Element>>,                                          \
+        const vector<shared_ptr<Matrix<Element>>> &, SignatureNonce<Element> *,               \
+        const string &, const vector<string> &, AttributeHashMode,                            \
+        const SubsetSumTable<Element> *);                                                     \
+    template signatureABS<Element> signOnline<Element>(                                       \
+        shared_ptr<GPVSignatureParameters<Element>>,                                          \
+        const vector<shared_ptr<Matrix<Element>>> &, SignatureNonce<Element> *,               \
+        ABSMessageSource &, const vector<string> &, AttributeHashMode,                        \
+        const SubsetSumTable<Element> *);                                                     \
+    template signatureABS<Element> sign<Element>(                                             \
+        shared_ptr<GPVSignatureParameters<Element>>,                                          \
+        const vector<shared_ptr<Matrix<Element>>> &, const GPVVerificationKey<Element> &,     \
+        ABSMessageSource &, const vector<string> &, TagEncoding, AttributeHashMode,           \
+        const PreparedVerificationKey<Element> *, const SubsetSumTable<Element> *);           \
+    template signatureABS<Element> sign<Element>(                                             \
+        shared_ptr<GPVSignatureParameters<Element>>,                                          \
+        const vector<shared_ptr<Matrix<Element>>> &, const GPVVerificationKey<Element> &,     \
+        ABSMessageSource &, const AttributeRegistry<Element> &, const vector<AttributeId> &,  \
+        TagEncoding, const PreparedVerificationKey<Element> *,                                \
+        const SubsetSumTable<Element> *);                                                     \
+    template void sign<Element>(                                                              \
+        shared_ptr<GPVSignatureParameters<Element>>,                                          \
+        const vector<shared_ptr<Matrix<Element>>> &, const GPVVerificationKey<Element> &,     \
+        ABSMessageSource &, const vector<string> &, SignWorkspace<Element> *,                 \
+        signatureABS<Element> *, TagEncoding, AttributeHashMode,                              \
+        const PreparedVerificationKey<Element> *, const SubsetSumTable<Element> *);           \
+    template vector<signatureABS<Element>> signBatch<Element>(                                \
+        shared_ptr<GPVSignatureParameters<Element>>,                                          \
+        const vector<shared_ptr<Matrix<Element>>> &, const GPVVerificationKey<Element> &,     \
+        const vector<string> &, const vector<string> &, TagEncoding, usint,                   \
+        AttributeHashMode, const PreparedVerificationKey<Element> *,                          \
+        const SubsetSumTable<Element> *);                                                     \
+    template bool verify<Element>(                                                            \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVVerificationKey<Element> &,     \
+        const string &, const signatureABS<Element> &, AttributeSyndromeCache<Element> *,     \
+        const PreparedVerificationKey<Element> *, SubsetSumTableCache<Element> *);            \
+    template bool verify<Element>(                                                            \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVVerificationKey<Element> &,     \
+        ABSMessageSource &, const signatureABS<Element> &, AttributeSyndromeCache<Element> *, \
+        const PreparedVerificationKey<Element> *, SubsetSumTableCache<Element> *);            \
+    template bool verify<Element>(                                                            \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVVerificationKey<Element> &,     \
+        ABSMessageSource &, const signatureABS<Element> &, VerifyWorkspace<Element> *,        \
+        AttributeSyndromeCache<Element> *, const PreparedVerificationKey<Element> *,          \
+        SubsetSumTableCache<Element> *);                                                      \
+    template bool verify<Element>(                                                            \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVVerificationKey<Element> &,     \
+        ABSMessageSource &, const signatureABS<Element> &, const AttributeRegistry<Element> &,\
+        const PreparedVerificationKey<Element> *, VerifyWorkspace<Element> *);                \
+    template Element signatureSyndrome<Element>(                                              \
+        shared_ptr<GPVSignatureParameters<Element>>, const signatureABS<Element> &,           \
+        AttributeSyndromeCache<Element> *, SubsetSumTableCache<Element> *);                   \
+    template bool verifyWithSyndromeSum<Element>(                                             \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVVerificationKey<Element> &,     \
+        const signatureABS<Element> &, const Element &, ABSMessageSource &,                   \
+        const PreparedVerificationKey<Element> *);                                            \
+    template vector<bool> verifyBatch<Element>(                                               \
+        shared_ptr<GPVSignatureParameters<Element>>, const GPVVerificationKey<Element> &,     \
+        const vector<std::pair<signatureABS<Element>, string>> &,                             \
+        AttributeSyndromeCache<Element> *, usint, const PreparedVerificationKey<Element> *,   \
+        SubsetSumTableCache<Element> *);
+
+ABS_INSTANTIATE(Poly)
+ABS_INSTANTIATE(NativePoly)
+ABS_INSTANTIATE(DCRTPoly)
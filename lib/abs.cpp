@@ -1,8 +1,20 @@
+#ifndef _SRC_LIB_ABS_CPP
+#define _SRC_LIB_ABS_CPP
+
 #include "abs.h"
-#include "signature/gpv.h"
+#include "abselement.h"
+#include "absparallel.h"
+#include "attributeregistry.h"
+#include "absstats.h"
+#include "sha256.h"
+#include "shake128.h"
+#include "gpv.h"
 #include "signaturecontext.h"
 #include "utils/inttypes.h"
 #include "utils/memory.h"
+#include "utils/parallel.h"
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <ostream>
 #include <ratio>
@@ -13,50 +25,343 @@ using namespace lbcrypto;
 //                              Helper functions                             //
 ///////////////////////////////////////////////////////////////////////////////
 
-// Public Syndrome matrix generator from a given set of attributes
-void attributeHashGenerator(vector<string> attributes, shared_ptr<GPVSignatureParameters<Poly>> m_params, Matrix<Poly> *attributesSyndrome) {
+// Public syndrome of a single attribute with the legacy hash: the SHA-256
+// digest of each index and attribute packed into the coefficients
+template <class Element>
+shared_ptr<const typename AttributeSyndromeCache<Element>::SyndromeRow> packedAttributeSyndrome(const string &attribute, shared_ptr<GPVSignatureParameters<Element>> m_params) {
     EncodingParams ep(std::make_shared<EncodingParamsImpl>(PlaintextModulus(512)));
-    vector<int64_t> digest;
-    Poly u;
+
+    auto row = std::make_shared<typename AttributeSyndromeCache<Element>::SyndromeRow>(32);
+    usint threads = absIntraOpThreads();
+
+    // The tag bits are independent, so with intra-operation workers each one
+    // encodes and transforms its own polynomials
+#pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (int j = 0; j < 32; j++) {
+        string auxAttr = std::to_string(j) + attribute;
+        vector<int64_t> digest;
+
+        lbcrypto::HashUtil::Hash(auxAttr, lbcrypto::SHA_256, digest);
+        lbcrypto::Plaintext hashedText(std::make_shared<lbcrypto::CoefPackedEncoding>(
+                                           m_params->GetILParams(), ep, digest));
+
+        hashedText->Encode();
+        Element u = hashedText->GetElement<Element>();
+        u.SwitchFormat();
+
+        (*row)[j] = std::move(u);
+    }
+
+    return row;
+}
+
+// Public syndrome of a single attribute: one polynomial per tag bit
+template <class Element>
+shared_ptr<const typename AttributeSyndromeCache<Element>::SyndromeRow> attributeSyndrome(const string &attribute, shared_ptr<GPVSignatureParameters<Element>> m_params, AttributeHashMode hashMode) {
+    ABS_STATS_PHASE(ABS_PHASE_ATTRIBUTE_SYNDROME);
+
+    if (hashMode == ATTRIBUTE_HASH_SHA256_PACKED) {
+        return packedAttributeSyndrome(attribute, m_params);
+    }
+    if (hashMode != ATTRIBUTE_HASH_SHAKE128) {
+        PALISADE_THROW(config_error, "Unknown attribute hash mode");
+    }
+
+    shared_ptr<typename Element::Params> params = m_params->GetILParams();
+
+    auto row = std::make_shared<typename AttributeSyndromeCache<Element>::SyndromeRow>(32);
+    usint threads = absIntraOpThreads();
+
+    // Each polynomial reads its own stream, separated by the mode and the tag
+    // bit index, so the streams can be split among intra-operation workers.
+    // Uniform values are as uniform in EVALUATION format, so they are written
+    // there directly and no NTT is needed
+#pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (int j = 0; j < 32; j++) {
+        uint8_t prefix[2] = {static_cast<uint8_t>(hashMode), static_cast<uint8_t>(j)};
+
+        SHAKE128 xof;
+        xof.update(prefix, sizeof(prefix));
+        xof.update(attribute.data(), attribute.size());
+
+        Element u(params, EVALUATION, true);
+        sampleUniform(&xof, &u);
+
+        (*row)[j] = std::move(u);
+    }
+
+    return row;
+}
+
+// Public Syndrome matrix generator from a given set of attributes
+template <class Element>
+void attributeHashGenerator(const vector<string> &attributes, shared_ptr<GPVSignatureParameters<Element>> m_params, Matrix<Element> *attributesSyndrome, AttributeSyndromeCache<Element> *cache, AttributeHashMode hashMode) {
+    ABS_STATS_PHASE(ABS_PHASE_ATTRIBUTE_HASH);
 
     for (auto i = attributes.begin(); i != attributes.end(); ++i) {
-        for (int j = 0; j < 32; j++) {
-            string auxAttr = std::to_string(j) + *i;
+        shared_ptr<const typename AttributeSyndromeCache<Element>::SyndromeRow> row;
 
-            lbcrypto::HashUtil::Hash(auxAttr, lbcrypto::SHA_256, digest);
-            lbcrypto::Plaintext hashedText(std::make_shared<lbcrypto::CoefPackedEncoding>(
-                                               m_params->GetILParams(), ep, digest));
+        // The same cache serves every hash mode, so the mode is part of the key
+        string cacheKey(1, static_cast<char>(hashMode));
+        cacheKey.append(*i);
 
-            // erase the digest value before the next use
-            digest.clear();
+        if (cache != nullptr) {
+            row = cache->lookup(cacheKey);
+        }
+
+        if (row == nullptr) {
+            row = attributeSyndrome(*i, m_params, hashMode);
+
+            if (cache != nullptr) {
+                cache->insert(cacheKey, row);
+            }
+        }
 
-            hashedText->Encode();
-            u = hashedText->GetElement<Poly>();
-            u.SwitchFormat();
+        // Sums the current attributes with the next one
+        usint threads = absIntraOpThreads();
 
-            // Sums the current attributes with the next one
-            (*attributesSyndrome)(0, j) = (*attributesSyndrome)(0, j) + u;
+#pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+        for (int j = 0; j < 32; j++) {
+            addInPlace(&(*attributesSyndrome)(0, j), (*row)[j]);
         }
     }
 
     return;
 }
 
-// Public 32 bit digest
-uint32_t compactDigest(shared_ptr<GPVSignatureParameters<Poly>> m_params, string message) {
-    EncodingParams ep(std::make_shared<EncodingParamsImpl>(PlaintextModulus(512)));
-    vector<int64_t> digest;
-    uint32_t h = 0;
+// First half of the message tag, absorbing the serialized ring element. The
+// decimal encoding keeps the string, the binary one absorbs the encoding
+// version first, so encodings never collide, and then streams the
+// coefficients straight into the hash
+template <class Element>
+void absorbSecret(const Element &secret, TagEncoding encoding, SHA256 *hash, string *decimalSecret,
+                  vector<uint8_t> *secretBytes) {
+    ABS_STATS_PHASE(ABS_PHASE_TAG_SECRET);
 
-    lbcrypto::HashUtil::Hash(message, lbcrypto::SHA_256, digest);
-    lbcrypto::Plaintext hashedText(std::make_shared<lbcrypto::CoefPackedEncoding>(
-                                       m_params->GetILParams(), ep, digest));
+    usint threads = absIntraOpThreads();
 
-    h += ((uint32_t)(digest[0] & 0xFF)) << 24;
-    h += ((uint32_t)(digest[1] & 0xFF)) << 16;
-    h += ((uint32_t)(digest[2] & 0xFF)) << 8;
-    h += ((uint32_t)(digest[3] & 0xFF));
-    return h;
+    if (encoding == TAG_ENCODING_DECIMAL) {
+        if (threads > 1) {
+            appendDecimalCoefficients(secret, decimalSecret, threads);
+        } else {
+            appendDecimalCoefficients(secret, decimalSecret);
+        }
+        return;
+    }
+
+    uint8_t version = static_cast<uint8_t>(encoding);
+
+    hash->reset();
+    hash->update(&version, 1);
+
+    // The hash itself is sequential, but with intra-operation workers the
+    // coefficients are serialized in parallel and absorbed in one call. The
+    // buffer is sized by prepareWorkspace, so the resize does not allocate
+    if (threads > 1) {
+        secretBytes->resize(coefficientBytes(secret));
+        serializeCoefficients(secret, secretBytes->data(), threads);
+        hash->update(secretBytes->data(), secretBytes->size());
+    } else {
+        hashCoefficients(secret, hash);
+    }
+}
+
+// Second half of the message tag: the serialized ring element concatenated
+// with the message, hashed to 32 bits. The message is absorbed chunk by chunk
+// as the source hands it out. The hash state is copied, so it is left as it was
+static uint32_t finishTag(TagEncoding encoding, const SHA256 &secretHash, const string &decimalSecret, ABSMessageSource &message) {
+    ABS_STATS_PHASE(ABS_PHASE_TAG_MESSAGE);
+
+    SHA256 hash = secretHash;
+
+    // The decimal tag is the plain SHA-256 of the string followed by the message
+    if (encoding == TAG_ENCODING_DECIMAL) {
+        hash.reset();
+        hash.update(decimalSecret.data(), decimalSecret.size());
+    }
+
+    const uint8_t *chunk;
+    size_t length;
+    while ((length = message.next(&chunk)) > 0) {
+        hash.update(chunk, length);
+    }
+
+    uint8_t digest[SHA256::DIGEST_SIZE];
+    hash.final(digest);
+
+    return (uint32_t(digest[0]) << 24) | (uint32_t(digest[1]) << 16) |
+           (uint32_t(digest[2]) << 8) | uint32_t(digest[3]);
+}
+
+// Allocates the polynomials of a workspace for the ring of the parameters,
+// unless they already are, along with the scratch of the intra-operation
+// workers of the calling thread. Returns true if the ring changed
+template <class Element>
+bool prepareWorkspace(shared_ptr<GPVSignatureParameters<Element>> m_params, TagWorkspace<Element> *workspace) {
+    shared_ptr<typename Element::Params> params = m_params->GetILParams();
+    bool changed = workspace->params != params;
+
+    if (changed) {
+        workspace->params = params;
+        workspace->product = Element(params, EVALUATION, true);
+        workspace->term = Element(params, EVALUATION, true);
+        workspace->partials.clear();
+        workspace->terms.clear();
+    }
+
+    usint threads = absIntraOpThreads();
+    if (threads > 1) {
+        while (workspace->partials.size() < threads) {
+            workspace->partials.emplace_back(params, EVALUATION, true);
+            workspace->terms.emplace_back(params, EVALUATION, true);
+        }
+        workspace->secretBytes.resize(coefficientBytes(workspace->product));
+    }
+    return changed;
+}
+
+template <class Element>
+void prepareWorkspace(shared_ptr<GPVSignatureParameters<Element>> m_params, SignWorkspace<Element> *workspace) {
+    if (prepareWorkspace<Element>(m_params, static_cast<TagWorkspace<Element> *>(workspace))) {
+        workspace->gaussian.resize(m_params->GetILParams()->GetRingDimension());
+        workspace->sample = Element(workspace->params, COEFFICIENT, true);
+    }
+}
+
+template <class Element>
+void prepareWorkspace(shared_ptr<GPVSignatureParameters<Element>> m_params, VerifyWorkspace<Element> *workspace) {
+    if (prepareWorkspace<Element>(m_params, static_cast<TagWorkspace<Element> *>(workspace))) {
+        workspace->hasSyndromes = false;
+        workspace->syndromeTable.reset();
+        workspace->syndromeMatrix = Matrix<Element>(Element::Allocator(workspace->params, EVALUATION), 1, 32);
+        workspace->syndromes = Element(workspace->params, EVALUATION, true);
+    }
+}
+
+// Tag of the product held by the workspace concatenated with the message
+template <class Element>
+uint32_t messageTag(TagWorkspace<Element> *workspace, ABSMessageSource &message, TagEncoding encoding) {
+    workspace->decimalSecret.clear();
+    absorbSecret(workspace->product, encoding, &workspace->secretHash, &workspace->decimalSecret,
+                 &workspace->secretBytes);
+    return finishTag(encoding, workspace->secretHash, workspace->decimalSecret, message);
+}
+
+// Column products of A*z split among intra-operation workers, each one
+// summing a slice of the columns into its own partial of the workspace. The
+// partials are then added in order, so the result does not depend on timing
+template <class Element>
+void publicProductParallel(const Matrix<Element> &A, const Matrix<Element> &z, usint threads,
+                           TagWorkspace<Element> *workspace) {
+    int workers = static_cast<int>(threads);
+    size_t cols = A.GetCols();
+
+#pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int w = 0; w < workers; w++) {
+        Element &partial = workspace->partials[w];
+        Element &term = workspace->terms[w];
+
+        partial.SetValuesToZero();
+        for (size_t j = cols * w / workers; j < cols * (w + 1) / workers; j++) {
+            term = A(0, j);
+            term *= z(j, 0);
+            addInPlace(&partial, term);
+        }
+    }
+
+    for (int w = 0; w < workers; w++) {
+        addInPlace(&workspace->product, workspace->partials[w]);
+    }
+}
+
+// Product of the verification key with a column vector into the workspace,
+// through the prepared key when there is one. Neither way builds temporaries
+template <class Element>
+void publicProduct(const Matrix<Element> &A, const Matrix<Element> &z, const PreparedVerificationKey<Element> *prepared,
+                   TagWorkspace<Element> *workspace) {
+    ABS_STATS_PHASE(ABS_PHASE_PUBLIC_PRODUCT);
+
+    if (prepared != nullptr) {
+        prepared->Multiply(z, &workspace->product, &workspace->words);
+        return;
+    }
+
+    workspace->product.SetValuesToZero();
+
+    usint threads = absIntraOpThreads();
+    if (threads > 1 && A.GetCols() > 1 && workspace->partials.size() >= threads) {
+        publicProductParallel(A, z, threads, workspace);
+        return;
+    }
+
+    for (size_t j = 0; j < A.GetCols(); j++) {
+        workspace->term = A(0, j);
+        workspace->term *= z(j, 0);
+        addInPlace(&workspace->product, workspace->term);
+    }
+}
+
+// Discrete gaussian vector of the signature, sampled in place polynomial by
+// polynomial with the generator of the calling thread and switched to
+// EVALUATION format. y is resized if it does not fit the key
+template <class Element>
+void gaussianVector(shared_ptr<GPVSignatureParameters<Element>> m_params, const Matrix<Element> &A,
+                    SignWorkspace<Element> *workspace, Matrix<Element> *y) {
+    if (y->GetRows() != A.GetCols() || y->GetCols() != A.GetRows()) {
+        *y = Matrix<Element>(Element::Allocator(workspace->params, EVALUATION), A.GetCols(), A.GetRows());
+    }
+
+    {
+        ABS_STATS_PHASE(ABS_PHASE_GAUSSIAN_SAMPLING);
+
+        typename Element::DggType &dgg = m_params->GetThreadDiscreteGaussianGenerator();
+        vector<int64_t> &gaussian = workspace->gaussian;
+
+        for (size_t r = 0; r < y->GetRows(); r++) {
+            for (size_t c = 0; c < y->GetCols(); c++) {
+                for (size_t i = 0; i < gaussian.size(); i++) {
+                    gaussian[i] = dgg.GenerateInt();
+                }
+                setCenteredCoefficients(gaussian.data(), &workspace->sample);
+                (*y)(r, c) = workspace->sample;
+            }
+        }
+    }
+    {
+        ABS_STATS_PHASE(ABS_PHASE_NTT);
+        y->SwitchFormat();
+    }
+}
+
+// Adds to y the attribute keys selected by the bits of the message tag,
+// through the subset sums of the key when there is a table
+template <class Element>
+void accumulateKeys(const vector<shared_ptr<Matrix<Element>>> &attributesKey, const SubsetSumTable<Element> *keyTable,
+                    uint32_t h, Matrix<Element> *sig) {
+    ABS_STATS_PHASE(ABS_PHASE_KEY_ACCUMULATION);
+
+    if (keyTable != nullptr) {
+        keyTable->accumulate(h, sig);
+        return;
+    }
+
+    // The rows of the signature are independent, so they are split among the
+    // intra-operation workers
+    usint threads = absIntraOpThreads();
+    int rows = static_cast<int>(sig->GetRows());
+
+#pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (int r = 0; r < rows; r++) {
+        for (int i = 0; i < 32; i++) {
+            if ((h >> (31 - i)) & 0x1) {
+                const Matrix<Element> &key = *attributesKey[i];
+
+                for (size_t c = 0; c < key.GetCols(); c++) {
+                    addInPlace(&(*sig)(r, c), key(r, c));
+                }
+            }
+        }
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -65,146 +370,697 @@ uint32_t compactDigest(shared_ptr<GPVSignatureParameters<Poly>> m_params, string
 
 // Setups the Attribute Authority keys and public parameters
 // Dummy for now (using the GPV normal keygen)
+template <class Element>
 void setup() {}
 
-// Extracts an user key using a set of attributes and AA keys
-vector<shared_ptr<Matrix<Poly>>> extract(shared_ptr<GPVSignatureParameters<Poly>> m_params,
-                                         const lbcrypto::GPVSignKey<Poly> &signKey,
-                                         const lbcrypto::GPVVerificationKey<Poly> &verificationKey,
-                                         vector<string> attributes) {
+// Samples a preimage of each column of the syndrome matrix under the
+// trapdoor, which together make the attribute key of an user
+template <class Element>
+vector<shared_ptr<Matrix<Element>>> samplePreimages(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                                   const lbcrypto::GPVSignKey<Element> &signKey,
+                                                   const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                                                   const Matrix<Element> &syndromeMatrix,
+                                                   usint numThreads,
+                                                   PerturbationPool<Element> *pool) {
 
     // Getting parameters for calculations
     size_t n = m_params->GetILParams()->GetRingDimension();
     size_t k = m_params->GetK();
     size_t base = m_params->GetBase();
 
-    shared_ptr<typename Poly::Params> params = m_params->GetILParams();
-    auto zero_alloc = Poly::Allocator(params, EVALUATION);
+    // Getting the trapdoor and its public matrix to use in sampling
+    const Matrix<Element> &A = verificationKey.GetVerificationKey();
+    const RLWETrapdoorPair<Element> &T = signKey.GetSignKey();
 
-    // Generate the syndrome matrix from a set of attributes
-    Matrix<Poly> syndromeMatrix(zero_alloc, 1, 32);
-    attributeHashGenerator(attributes, m_params, &syndromeMatrix);
+    // Perturbations only fit the trapdoor they were sampled for
+    if (pool != nullptr && !pool->IsBoundTo(signKey)) {
+        PALISADE_THROW(config_error, "Perturbation pool belongs to a different sign key");
+    }
 
-    // Getting the trapdoor, its public matrix, perturbation matrix and gaussian
-    // generator to use in sampling
-    const Matrix<Poly> &A = verificationKey.GetVerificationKey();
-    const RLWETrapdoorPair<Poly> &T = signKey.GetSignKey();
-    typename Poly::DggType &dgg = m_params->GetDiscreteGaussianGenerator();
+    // Set of solutions to the SIS problem will be the users attributes key
+    int cols = static_cast<int>(syndromeMatrix.GetCols());
+    vector<shared_ptr<Matrix<Element>>> attributesKey(cols);
 
-    typename Poly::DggType &dggLargeSigma = m_params->GetDiscreteGaussianGeneratorLargeSigma();
+    if (numThreads == 0) {
+        numThreads = PalisadeParallelControls.GetMachineThreads();
+    }
 
-    // Set of solutions to the SIS problem will be the users attributes key
-    vector<shared_ptr<Matrix<Poly>>> attributesKey;
+    // Sample a preimage for each syndrome. The samples are independent, so the
+    // columns are split among the workers. Each worker uses the copies of the
+    // gaussian generators private to its thread (the PRNG underneath is thread
+    // private too), which keeps the output distribution the same as the
+    // sequential sampling and lets concurrent calls share the parameters. When a
+    // pool is given, the perturbations come precomputed from it and only the
+    // online part of the sampling is done here
+#pragma omp parallel num_threads(numThreads)
+    {
+        typename Element::DggType &dgg = m_params->GetThreadDiscreteGaussianGenerator();
+        typename Element::DggType &dggLargeSigma = m_params->GetThreadDiscreteGaussianGeneratorLargeSigma();
 
-    // Sample a preimage for each syndrome
-    for (int i = 0; i < static_cast<int>(syndromeMatrix.GetCols()); i++) {
-        auto u = syndromeMatrix(0, i);
-        Matrix<Poly> zHat = RLWETrapdoorUtility<Poly>::GaussSamp(
-            n, k, A, T, u, dgg, dggLargeSigma, base);
-        attributesKey.push_back(std::make_shared<Matrix<Poly>>(zHat));
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < cols; i++) {
+            ABS_STATS_PHASE(ABS_PHASE_PREIMAGE_SAMPLING);
+
+            if (pool != nullptr) {
+                Matrix<Element> zHat = RLWETrapdoorUtility<Element>::GaussSampOnline(
+                    n, k, A, T, syndromeMatrix(0, i), dgg, pool->Take(), base);
+                attributesKey[i] = std::make_shared<Matrix<Element>>(std::move(zHat));
+            } else {
+                Matrix<Element> zHat = RLWETrapdoorUtility<Element>::GaussSamp(
+                    n, k, A, T, syndromeMatrix(0, i), dgg, dggLargeSigma, base);
+                attributesKey[i] = std::make_shared<Matrix<Element>>(std::move(zHat));
+            }
+        }
     }
 
     return attributesKey;
 }
 
-// Signs a message using an attribute based key
-signatureABS sign(shared_ptr<GPVSignatureParameters<Poly>> m_params,
-                  vector<shared_ptr<Matrix<Poly>>> attributesKey,
-                  const lbcrypto::GPVVerificationKey<Poly> &verificationKey,
-                  string message,
-                  vector<string> attributeList){
+// A registry built for another ring would hand out syndromes of the wrong size
+template <class Element>
+void checkRegistry(shared_ptr<GPVSignatureParameters<Element>> m_params, const AttributeRegistry<Element> &registry) {
+    if (!registry.isBuiltFor(m_params)) {
+        PALISADE_THROW(config_error, "Attribute registry belongs to different parameters");
+    }
+}
 
-    // Get parameters from keys
-    shared_ptr<typename Poly::Params> params = m_params->GetILParams();
-    auto stddev = m_params->GetDiscreteGaussianGenerator().GetStd();
-    auto zero_alloc = Poly::Allocator(params, EVALUATION);
-    auto gaussian_alloc = Poly::MakeDiscreteGaussianCoefficientAllocator(
-        params, COEFFICIENT, stddev);
+// Extracts an user key using a set of attributes and AA keys
+template <class Element>
+vector<shared_ptr<Matrix<Element>>> extract(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                         const lbcrypto::GPVSignKey<Element> &signKey,
+                                         const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                                         const vector<string> &attributes,
+                                         AttributeSyndromeCache<Element> *cache,
+                                         usint numThreads,
+                                         PerturbationPool<Element> *pool,
+                                         AttributeHashMode hashMode) {
 
-    const Matrix<Poly> &A = verificationKey.GetVerificationKey();
+    auto zero_alloc = Element::Allocator(m_params->GetILParams(), EVALUATION);
 
-    // Sample a discrete gaussian y vector
-    Matrix<Poly> y(zero_alloc, A.GetCols(), A.GetRows(), gaussian_alloc);
-    y.SwitchFormat();
+    // Generate the syndrome matrix from a set of attributes
+    Matrix<Element> syndromeMatrix(zero_alloc, 1, 32);
+    attributeHashGenerator(attributes, m_params, &syndromeMatrix, cache, hashMode);
+
+    return samplePreimages(m_params, signKey, verificationKey, syndromeMatrix, numThreads, pool);
+}
 
-    // This will be our secret that will grant the integrity to the signature
-    Poly secret = (A * y)(0, 0);
+// Extracts an user key for registered attributes
+template <class Element>
+vector<shared_ptr<Matrix<Element>>> extract(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                         const lbcrypto::GPVSignKey<Element> &signKey,
+                                         const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                                         const AttributeRegistry<Element> &registry,
+                                         const vector<AttributeId> &attributes,
+                                         usint numThreads,
+                                         PerturbationPool<Element> *pool) {
 
-    // The secret will be concatenated with the message and everything will be
-    // hashed to a 32 bit tag, represented by a 32 unsigned integer
-    string secretWithMessage;
+    checkRegistry(m_params, registry);
+
+    auto zero_alloc = Element::Allocator(m_params->GetILParams(), EVALUATION);
+
+    // The syndrome matrix is the sum of the rows of the registry table
+    Matrix<Element> syndromeMatrix(zero_alloc, 1, 32);
+    registry.syndromeMatrix(attributes, &syndromeMatrix);
+
+    return samplePreimages(m_params, signKey, verificationKey, syndromeMatrix, numThreads, pool);
+}
 
-    for (usint i = 0; i < secret.GetLength(); i++) {
-        secretWithMessage.append(secret[i].ToString());
+// A table built from another key would add the wrong keys to the signature
+template <class Element>
+void checkKeyTable(const vector<shared_ptr<Matrix<Element>>> &attributesKey, const SubsetSumTable<Element> *keyTable) {
+    if (keyTable != nullptr && !keyTable->isBuiltFrom(attributesKey)) {
+        PALISADE_THROW(config_error, "Subset sum table belongs to a different attribute key");
     }
-    secretWithMessage.append(message);
+}
+
+// Samples y and hashes the secret A*y for a later signature
+template <class Element>
+shared_ptr<SignatureNonce<Element>> signOffline(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                               const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                                               TagEncoding encoding,
+                                               const PreparedVerificationKey<Element> *prepared) {
+
+    const Matrix<Element> &A = verificationKey.GetVerificationKey();
+
+    // The nonce keeps y, so only the scratch polynomials are left behind
+    SignWorkspace<Element> workspace;
+    prepareWorkspace(m_params, &workspace);
+
+    // Sample a discrete gaussian y vector
+    Matrix<Element> y;
+    gaussianVector(m_params, A, &workspace, &y);
+
+    // This will be our secret that will grant the integrity to the signature.
+    // Its serialization is hashed now, the message is appended online
+    publicProduct(A, y, prepared, &workspace);
+
+    auto nonce = std::make_shared<SignatureNonce<Element>>(std::move(y), encoding);
+    absorbSecret(workspace.product, encoding, &nonce->secretHash, &nonce->decimalSecret, &workspace.secretBytes);
 
-    // Message tag generation
-    uint32_t h = compactDigest(m_params, secretWithMessage);
+    return nonce;
+}
+
+// Signs a message with a nonce made by signOffline
+template <class Element>
+signatureABS<Element> signOnline(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                 const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                                 SignatureNonce<Element> *nonce,
+                                 ABSMessageSource &message,
+                                 const vector<string> &attributeList,
+                                 AttributeHashMode hashMode,
+                                 const SubsetSumTable<Element> *keyTable) {
+
+    checkKeyTable(attributesKey, keyTable);
+
+    // The secret concatenated with the message is hashed to a 32 bit tag,
+    // represented by a 32 unsigned integer
+    uint32_t h = finishTag(nonce->encoding, nonce->secretHash, nonce->decimalSecret, message);
 
     // The signature will be a superposition of the SIS solutions (secret
     // attributes keys) summed with the secret gaussian vector y
-    Matrix<Poly> sig = y;
-
-    for (int i = 0; i < 32; i++) {
-        if ((h >> (31 - i)) & 0x1) {
-            sig += *attributesKey[i];
-        }
-    }
+    Matrix<Element> sig = std::move(nonce->y);
+    accumulateKeys(attributesKey, keyTable, h, &sig);
 
     // The full signature with the parameters consists of:
     // - the attribute list for which this signature is valid
     // - the message tag
     // - the signature lattice point
-    signatureABS *signature = new signatureABS(attributeList, h, sig);
+    // - the encodings needed to check the tag
+    return signatureABS<Element>(attributeList, h, std::move(sig), nonce->encoding, hashMode);
+}
 
-    return *signature;
+template <class Element>
+signatureABS<Element> signOnline(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                 const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                                 SignatureNonce<Element> *nonce,
+                                 const string &message,
+                                 const vector<string> &attributeList,
+                                 AttributeHashMode hashMode,
+                                 const SubsetSumTable<Element> *keyTable) {
+    MemoryMessageSource source(message);
+    return signOnline(m_params, attributesKey, nonce, source, attributeList, hashMode, keyTable);
 }
 
-// Verifies if the signature is valid for the message and the given attributes
-bool verify(shared_ptr<GPVSignatureParameters<Poly>> m_params,
-            const lbcrypto::GPVVerificationKey<Poly> &verificationKey,
-            string message,
-            signatureABS signature){
+// Signs a message using an attribute based key
+template <class Element>
+signatureABS<Element> sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                  const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                  const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                  const string &message,
+                  const vector<string> &attributeList,
+                  TagEncoding encoding,
+                  AttributeHashMode hashMode,
+                  const PreparedVerificationKey<Element> *prepared,
+                  const SubsetSumTable<Element> *keyTable){
 
-    // Get common lattice parameters
-    shared_ptr<Poly::Params> params = m_params->GetILParams();
-    auto zero_alloc = Poly::Allocator(params, EVALUATION);
+    MemoryMessageSource source(message);
+    return sign(m_params, attributesKey, verificationKey, source, attributeList, encoding, hashMode, prepared, keyTable);
+}
 
-    // Get the parameters from the signature
-    vector<string> attributeList = signature.getAttributeList();
-    Matrix<Poly> z = signature.getSignature();
-    uint32_t h = signature.getSignatureHash();
+// Signs a message read from a source, hashing it in chunks
+template <class Element>
+signatureABS<Element> sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                  const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                  const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                  ABSMessageSource &message,
+                  const vector<string> &attributeList,
+                  TagEncoding encoding,
+                  AttributeHashMode hashMode,
+                  const PreparedVerificationKey<Element> *prepared,
+                  const SubsetSumTable<Element> *keyTable){
 
-    const Matrix<Poly> &A = verificationKey.GetVerificationKey();
+    shared_ptr<SignatureNonce<Element>> nonce = signOffline(m_params, verificationKey, encoding, prepared);
 
-    // First part of the signature verification
-    Poly sigAux = (A * z)(0, 0);
+    return signOnline(m_params, attributesKey, nonce.get(), message, attributeList, hashMode, keyTable);
+}
+
+// Signs a message for registered attributes
+template <class Element>
+signatureABS<Element> sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                  const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                  const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                  ABSMessageSource &message,
+                  const AttributeRegistry<Element> &registry,
+                  const vector<AttributeId> &attributes,
+                  TagEncoding encoding,
+                  const PreparedVerificationKey<Element> *prepared,
+                  const SubsetSumTable<Element> *keyTable){
+
+    checkRegistry(m_params, registry);
+
+    // The names are looked up first, so an unknown id fails before sampling
+    vector<string> attributeList = registry.getNames(attributes);
+
+    shared_ptr<SignatureNonce<Element>> nonce = signOffline(m_params, verificationKey, encoding, prepared);
+
+    signatureABS<Element> signature = signOnline(m_params, attributesKey, nonce.get(), message, attributeList,
+                                                 registry.getHashMode(), keyTable);
+    signature.setAttributeIds(attributes);
+
+    return signature;
+}
+
+// Samples y into sig, hashes A*y with the message and adds the keys selected
+// by the tag, all within the workspace. Returns the tag
+template <class Element>
+uint32_t signLatticePoint(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                          const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                          const Matrix<Element> &A,
+                          ABSMessageSource &message,
+                          TagEncoding encoding,
+                          const PreparedVerificationKey<Element> *prepared,
+                          const SubsetSumTable<Element> *keyTable,
+                          SignWorkspace<Element> *workspace,
+                          Matrix<Element> *sig) {
 
-    // Generate the public matrix for the signature attributes
-    Matrix<Poly> syndromeMatrix(zero_alloc, 1, 32);
-    attributeHashGenerator(attributeList, m_params, &syndromeMatrix);
+    prepareWorkspace(m_params, workspace);
 
-    // Second part of the signature verification
-    Poly sigAux2(params, EVALUATION, true);
+    gaussianVector(m_params, A, workspace, sig);
+    publicProduct(A, *sig, prepared, workspace);
+
+    uint32_t h = messageTag(workspace, message, encoding);
+    accumulateKeys(attributesKey, keyTable, h, sig);
+
+    return h;
+}
+
+// Signs a message into a reused signature
+template <class Element>
+void sign(shared_ptr<GPVSignatureParameters<Element>> m_params,
+          const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+          const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+          ABSMessageSource &message,
+          const vector<string> &attributeList,
+          SignWorkspace<Element> *workspace,
+          signatureABS<Element> *signature,
+          TagEncoding encoding,
+          AttributeHashMode hashMode,
+          const PreparedVerificationKey<Element> *prepared,
+          const SubsetSumTable<Element> *keyTable) {
+
+    checkKeyTable(attributesKey, keyTable);
+
+    uint32_t h = signLatticePoint(m_params, attributesKey, verificationKey.GetVerificationKey(), message, encoding,
+                                  prepared, keyTable, workspace, &signature->getSignature());
+
+    signature->setAttributeList(attributeList);
+    signature->setSignatureHash(h);
+    signature->setTagEncoding(encoding);
+    signature->setHashMode(hashMode);
+}
+
+// Signs many messages with the same attribute based key
+template <class Element>
+vector<signatureABS<Element>> signBatch(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                               const vector<shared_ptr<Matrix<Element>>> &attributesKey,
+                               const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                               const vector<string> &messages,
+                               const vector<string> &attributeList,
+                               TagEncoding encoding,
+                               usint numThreads,
+                               AttributeHashMode hashMode,
+                               const PreparedVerificationKey<Element> *prepared,
+                               const SubsetSumTable<Element> *keyTable) {
+
+    checkKeyTable(attributesKey, keyTable);
+
+    const Matrix<Element> &A = verificationKey.GetVerificationKey();
+
+    if (numThreads == 0) {
+        numThreads = PalisadeParallelControls.GetMachineThreads();
+    }
+
+    // Every message gets its own gaussian y, secret A*y and tag. The key is
+    // only read, so all the messages share it
+    int numMessages = static_cast<int>(messages.size());
+    vector<Matrix<Element>> sigs(numMessages);
+    vector<uint32_t> tags(numMessages);
+
+#pragma omp parallel num_threads(numThreads)
+    {
+        // Each worker samples with the generator of its thread and reuses its
+        // own scratch polynomials from one message to the next
+        SignWorkspace<Element> workspace;
+
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < numMessages; i++) {
+            MemoryMessageSource message(messages[i]);
+            tags[i] = signLatticePoint(m_params, attributesKey, A, message, encoding, prepared, keyTable,
+                                       &workspace, &sigs[i]);
+        }
+    }
+
+    vector<signatureABS<Element>> signatures;
+    signatures.reserve(numMessages);
+
+    for (int i = 0; i < numMessages; i++) {
+        signatures.emplace_back(attributeList, tags[i], std::move(sigs[i]), encoding, hashMode);
+    }
+
+    return signatures;
+}
+
+// Adds to sum the syndromes selected by the bits of the tag, given either as
+// the syndrome matrix of the attributes or as its subset sum table
+template <class Element>
+void accumulateSyndromes(const Matrix<Element> *syndromeMatrix,
+                         const SubsetSumTable<Element> *syndromeTable,
+                         uint32_t h,
+                         Element *sum) {
+    ABS_STATS_PHASE(ABS_PHASE_SYNDROME_ACCUMULATION);
+
+    if (syndromeTable != nullptr) {
+        syndromeTable->accumulate(h, sum);
+        return;
+    }
 
     for (int i = 0; i < 32; i++) {
         if ((h >> (31 - i)) & 0x1) {
-            sigAux2 += syndromeMatrix(0, i);
+            addInPlace(sum, (*syndromeMatrix)(0, i));
         }
     }
+}
+
+// Checks the tag of a signature lattice point against the sum of the
+// syndromes it selects
+template <class Element>
+bool checkTag(const Matrix<Element> &A,
+              const Matrix<Element> &z,
+              const Element &syndromes,
+              uint32_t h,
+              TagEncoding encoding,
+              ABSMessageSource &message,
+              const PreparedVerificationKey<Element> *prepared,
+              TagWorkspace<Element> *workspace) {
+
+    // First part of the signature verification
+    publicProduct(A, z, prepared, workspace);
 
     // Final signature verification computation
-    Poly sigHat = sigAux - sigAux2;
+    subInPlace(&workspace->product, syndromes);
 
     // Serialization of the array to generate the hash tag
-    string sigHatString;
-    for (uint i = 0; i < sigHat.GetLength(); i++) {
-        sigHatString.append(sigHat[i].ToString());
+    uint32_t hHat = messageTag(workspace, message, encoding);
+
+    return h == hHat;
+}
+
+// Checks the tag of a signature lattice point against the syndromes of its
+// attributes, given either as their matrix or as their subset sum table
+template <class Element>
+bool verifyWithSyndrome(const Matrix<Element> &A,
+                        const Matrix<Element> *syndromeMatrix,
+                        const SubsetSumTable<Element> *syndromeTable,
+                        const Matrix<Element> &z,
+                        uint32_t h,
+                        TagEncoding encoding,
+                        ABSMessageSource &message,
+                        const PreparedVerificationKey<Element> *prepared,
+                        VerifyWorkspace<Element> *workspace) {
+
+    workspace->syndromes.SetValuesToZero();
+    accumulateSyndromes(syndromeMatrix, syndromeTable, h, &workspace->syndromes);
+
+    return checkTag(A, z, workspace->syndromes, h, encoding, message, prepared, workspace);
+}
+
+// Order independent key identifying a set of attributes, as the syndrome of
+// a set is the sum of the syndromes of its attributes. Sets hashed with
+// different modes have different syndromes, so the mode comes first
+static string attributeSetKey(vector<string> attributes, AttributeHashMode hashMode) {
+    std::sort(attributes.begin(), attributes.end());
+
+    string key(1, static_cast<char>(hashMode));
+    for (auto i = attributes.begin(); i != attributes.end(); ++i) {
+        key.append(std::to_string(i->size()));
+        key.push_back(':');
+        key.append(*i);
+    }
+
+    return key;
+}
+
+// Subset sum table of the syndromes of an attribute set, hashing the
+// attributes only when the table is not cached yet
+template <class Element>
+shared_ptr<const SubsetSumTable<Element>> syndromeTable(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                                       const vector<string> &attributes,
+                                                       AttributeHashMode hashMode,
+                                                       AttributeSyndromeCache<Element> *cache,
+                                                       SubsetSumTableCache<Element> *syndromeTables) {
+    string key = attributeSetKey(attributes, hashMode);
+
+    shared_ptr<const SubsetSumTable<Element>> table = syndromeTables->lookup(key);
+    if (table == nullptr) {
+        auto zero_alloc = Element::Allocator(m_params->GetILParams(), EVALUATION);
+        Matrix<Element> syndromeMatrix(zero_alloc, 1, 32);
+        attributeHashGenerator(attributes, m_params, &syndromeMatrix, cache, hashMode);
+
+        table = std::make_shared<const SubsetSumTable<Element>>(syndromeMatrix, syndromeTables->getWindowBits());
+        syndromeTables->insert(key, table);
     }
-    sigHatString.append(message);
 
-    uint32_t hHat = compactDigest(m_params, sigHatString);
+    return table;
+}
+
+// Syndrome half of verify, which only depends on the attributes and tag
+template <class Element>
+Element signatureSyndrome(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                          const signatureABS<Element> &signature,
+                          AttributeSyndromeCache<Element> *cache,
+                          SubsetSumTableCache<Element> *syndromeTables) {
 
-    return h == hHat;
+    shared_ptr<typename Element::Params> params = m_params->GetILParams();
+    Element sum(params, EVALUATION, true);
+
+    if (syndromeTables != nullptr) {
+        shared_ptr<const SubsetSumTable<Element>> table = syndromeTable(
+            m_params, signature.getAttributeList(), signature.getHashMode(), cache, syndromeTables);
+
+        accumulateSyndromes<Element>(nullptr, table.get(), signature.getSignatureHash(), &sum);
+        return sum;
+    }
+
+    Matrix<Element> syndromeMatrix(Element::Allocator(params, EVALUATION), 1, 32);
+    attributeHashGenerator(signature.getAttributeList(), m_params, &syndromeMatrix, cache, signature.getHashMode());
+
+    accumulateSyndromes<Element>(&syndromeMatrix, nullptr, signature.getSignatureHash(), &sum);
+    return sum;
+}
+
+// Lattice and hash half of verify
+template <class Element>
+bool verifyWithSyndromeSum(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                           const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                           const signatureABS<Element> &signature,
+                           const Element &syndromes,
+                           ABSMessageSource &message,
+                           const PreparedVerificationKey<Element> *prepared) {
+
+    TagWorkspace<Element> workspace;
+    prepareWorkspace(m_params, &workspace);
+
+    return checkTag(verificationKey.GetVerificationKey(), signature.getSignature(), syndromes,
+                    signature.getSignatureHash(), signature.getTagEncoding(), message, prepared, &workspace);
+}
+
+// Verifies if the signature is valid for the message and the given attributes
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            const string &message,
+            const signatureABS<Element> &signature,
+            AttributeSyndromeCache<Element> *cache,
+            const PreparedVerificationKey<Element> *prepared,
+            SubsetSumTableCache<Element> *syndromeTables){
+
+    MemoryMessageSource source(message);
+    return verify(m_params, verificationKey, source, signature, cache, prepared, syndromeTables);
+}
+
+// Verifies a signature of a message read from a source, hashing it in chunks
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            ABSMessageSource &message,
+            const signatureABS<Element> &signature,
+            AttributeSyndromeCache<Element> *cache,
+            const PreparedVerificationKey<Element> *prepared,
+            SubsetSumTableCache<Element> *syndromeTables){
+
+    VerifyWorkspace<Element> workspace;
+    return verify(m_params, verificationKey, message, signature, &workspace, cache, prepared, syndromeTables);
+}
+
+// Verifies a signature with a reused workspace
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            ABSMessageSource &message,
+            const signatureABS<Element> &signature,
+            VerifyWorkspace<Element> *workspace,
+            AttributeSyndromeCache<Element> *cache,
+            const PreparedVerificationKey<Element> *prepared,
+            SubsetSumTableCache<Element> *syndromeTables){
+
+    prepareWorkspace(m_params, workspace);
+
+    // The syndromes are only generated again for another attribute set
+    if (!workspace->hasSyndromes || workspace->hashMode != signature.getHashMode() ||
+        workspace->attributes != signature.getAttributeList()) {
+        workspace->hasSyndromes = false;
+
+        if (syndromeTables != nullptr) {
+            workspace->syndromeTable = syndromeTable(
+                m_params, signature.getAttributeList(), signature.getHashMode(), cache, syndromeTables);
+        } else {
+            workspace->syndromeTable.reset();
+            for (size_t i = 0; i < workspace->syndromeMatrix.GetCols(); i++) {
+                workspace->syndromeMatrix(0, i).SetValuesToZero();
+            }
+            attributeHashGenerator(signature.getAttributeList(), m_params, &workspace->syndromeMatrix, cache,
+                                   signature.getHashMode());
+        }
+
+        workspace->attributes = signature.getAttributeList();
+        workspace->hashMode = signature.getHashMode();
+        workspace->hasSyndromes = true;
+    }
+
+    const SubsetSumTable<Element> *table = workspace->syndromeTable.get();
+
+    return verifyWithSyndrome(verificationKey.GetVerificationKey(), table == nullptr ? &workspace->syndromeMatrix : nullptr,
+                              table, signature.getSignature(), signature.getSignatureHash(),
+                              signature.getTagEncoding(), message, prepared, workspace);
 }
+
+// Verifies a signature with the syndromes of a registry
+template <class Element>
+bool verify(shared_ptr<GPVSignatureParameters<Element>> m_params,
+            const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+            ABSMessageSource &message,
+            const signatureABS<Element> &signature,
+            const AttributeRegistry<Element> &registry,
+            const PreparedVerificationKey<Element> *prepared,
+            VerifyWorkspace<Element> *workspace){
+
+    checkRegistry(m_params, registry);
+
+    if (signature.getHashMode() != registry.getHashMode()) {
+        PALISADE_THROW(config_error, "Signature attributes were hashed with another mode than the registry");
+    }
+
+    VerifyWorkspace<Element> local;
+    if (workspace == nullptr) {
+        workspace = &local;
+    }
+    prepareWorkspace(m_params, workspace);
+
+    // A signature read back has no ids, and the ids of any other one may have
+    // been assigned by another registry or left over from another list, so
+    // unless they name its attributes these are looked up by name once
+    const vector<AttributeId> *ids = &signature.getAttributeIds();
+    vector<AttributeId> found;
+
+    if (!registry.matches(*ids, signature.getAttributeList())) {
+        found = registry.getIds(signature.getAttributeList());
+        ids = &found;
+    }
+
+    uint32_t h = signature.getSignatureHash();
+
+    workspace->syndromes.SetValuesToZero();
+    {
+        ABS_STATS_PHASE(ABS_PHASE_SYNDROME_ACCUMULATION);
+        registry.accumulate(*ids, h, &workspace->syndromes);
+    }
+
+    return checkTag(verificationKey.GetVerificationKey(), signature.getSignature(), workspace->syndromes, h,
+                    signature.getTagEncoding(), message, prepared, workspace);
+}
+
+// Verifies a batch of signatures under the same verification key
+template <class Element>
+vector<bool> verifyBatch(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                         const lbcrypto::GPVVerificationKey<Element> &verificationKey,
+                         const vector<std::pair<signatureABS<Element>, string>> &batch,
+                         AttributeSyndromeCache<Element> *cache,
+                         usint numThreads,
+                         const PreparedVerificationKey<Element> *prepared,
+                         SubsetSumTableCache<Element> *syndromeTables) {
+
+    // Get common lattice parameters
+    shared_ptr<typename Element::Params> params = m_params->GetILParams();
+    auto zero_alloc = Element::Allocator(params, EVALUATION);
+
+    const Matrix<Element> &A = verificationKey.GetVerificationKey();
+
+    if (numThreads == 0) {
+        numThreads = PalisadeParallelControls.GetMachineThreads();
+    }
+
+    // Group the signatures by attribute set, so the syndrome matrix of each
+    // distinct set is generated only once for the whole batch
+    std::map<string, size_t> setIndex;
+    vector<vector<string>> setAttributes;
+    vector<AttributeHashMode> setHashModes;
+    vector<size_t> itemSet(batch.size());
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        const vector<string> &attributes = batch[i].first.getAttributeList();
+        AttributeHashMode hashMode = batch[i].first.getHashMode();
+        auto inserted = setIndex.insert(std::make_pair(attributeSetKey(attributes, hashMode), setAttributes.size()));
+
+        if (inserted.second) {
+            setAttributes.push_back(attributes);
+            setHashModes.push_back(hashMode);
+        }
+        itemSet[i] = inserted.first->second;
+    }
+
+    // With a table cache, each set is accumulated through its subset sums
+    // instead, and the hashing is skipped for the sets already cached
+    int numSets = static_cast<int>(setAttributes.size());
+    vector<Matrix<Element>> syndromes;
+    vector<shared_ptr<const SubsetSumTable<Element>>> tables(numSets);
+
+    if (syndromeTables == nullptr) {
+        syndromes.assign(numSets, Matrix<Element>(zero_alloc, 1, 32));
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(numThreads)
+    for (int s = 0; s < numSets; s++) {
+        if (syndromeTables != nullptr) {
+            tables[s] = syndromeTable(m_params, setAttributes[s], setHashModes[s], cache, syndromeTables);
+        } else {
+            attributeHashGenerator(setAttributes[s], m_params, &syndromes[s], cache, setHashModes[s]);
+        }
+    }
+
+    // The items only share read-only data, so they are checked independently.
+    // The results are gathered in bytes as vector<bool> can not be written
+    // concurrently
+    int numItems = static_cast<int>(batch.size());
+    vector<char> results(numItems);
+
+#pragma omp parallel num_threads(numThreads)
+    {
+        VerifyWorkspace<Element> workspace;
+        prepareWorkspace(m_params, &workspace);
+
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < numItems; i++) {
+            const signatureABS<Element> &signature = batch[i].first;
+            const Matrix<Element> *syndromeMatrix = syndromeTables == nullptr ? &syndromes[itemSet[i]] : nullptr;
+            MemoryMessageSource message(batch[i].second);
+
+            results[i] = verifyWithSyndrome(A, syndromeMatrix, tables[itemSet[i]].get(),
+                                            signature.getSignature(), signature.getSignatureHash(),
+                                            signature.getTagEncoding(), message, prepared, &workspace);
+        }
+    }
+
+    return vector<bool>(results.begin(), results.end());
+}
+
+#endif
@@ -0,0 +1,142 @@
+#include "abselement.h"
+#include "simdkernels.h"
+#include <type_traits>
+
+// NativeInteger wraps a single machine word, so the coefficients of a
+// NativePoly are a contiguous array of words the kernels can work on
+static_assert(sizeof(NativeInteger) == sizeof(uint64_t) && std::is_standard_layout<NativeInteger>::value,
+              "NativeInteger must be a plain 64 bit word");
+
+static uint64_t *nativeWords(NativePoly *element) {
+    return reinterpret_cast<uint64_t *>(&(*element)[0]);
+}
+
+static const uint64_t *nativeWords(const NativePoly &element) {
+    return reinterpret_cast<const uint64_t *>(&element[0]);
+}
+
+static void checkCompatible(const NativePoly &a, const NativePoly &b) {
+    if (a.GetFormat() != b.GetFormat() || a.GetLength() != b.GetLength() || a.GetModulus() != b.GetModulus()) {
+        PALISADE_THROW(math_error, "Ring elements of different rings or formats");
+    }
+}
+
+void appendDecimalCoefficients(const DCRTPoly &element, string *out) {
+    appendDecimalCoefficients(element.CRTInterpolate(), out);
+}
+
+void appendDecimalCoefficients(const DCRTPoly &element, string *out, usint threads) {
+    appendDecimalCoefficients(element.CRTInterpolate(), out, threads);
+}
+
+size_t coefficientBytes(const DCRTPoly &element) {
+    size_t bytes = 0;
+    for (usint t = 0; t < element.GetNumOfElements(); t++) {
+        bytes += coefficientBytes(element.GetElementAtIndex(t));
+    }
+    return bytes;
+}
+
+void serializeCoefficients(const DCRTPoly &element, uint8_t *out, usint threads) {
+    for (usint t = 0; t < element.GetNumOfElements(); t++) {
+        const NativePoly &tower = element.GetElementAtIndex(t);
+        serializeCoefficients(tower, out, threads);
+        out += coefficientBytes(tower);
+    }
+}
+
+void hashCoefficients(const DCRTPoly &element, SHA256 *hash) {
+    for (usint t = 0; t < element.GetNumOfElements(); t++) {
+        hashCoefficients(element.GetElementAtIndex(t), hash);
+    }
+}
+
+void sampleUniform(SHAKE128 *xof, DCRTPoly *element) {
+    for (usint t = 0; t < element->GetNumOfElements(); t++) {
+        sampleUniform(xof, &element->ElementAtIndex(t));
+    }
+}
+
+void getCenteredCoefficients(const DCRTPoly &element, vector<int64_t> *out) {
+    getCenteredCoefficients(element.GetElementAtIndex(0), out);
+
+    vector<int64_t> tower;
+    for (usint t = 1; t < element.GetNumOfElements(); t++) {
+        getCenteredCoefficients(element.GetElementAtIndex(t), &tower);
+
+        if (tower != *out) {
+            PALISADE_THROW(math_error, "Coefficients too large for the smallest tower");
+        }
+    }
+}
+
+void setCenteredCoefficients(const int64_t *values, DCRTPoly *element) {
+    for (usint t = 0; t < element->GetNumOfElements(); t++) {
+        setCenteredCoefficients(values, &element->ElementAtIndex(t));
+    }
+}
+
+void exportCoefficients(const DCRTPoly &element, uint64_t *out) {
+    for (usint t = 0; t < element.GetNumOfElements(); t++) {
+        exportCoefficients(element.GetElementAtIndex(t), out + t * element.GetRingDimension());
+    }
+}
+
+void importCoefficients(const uint64_t *in, DCRTPoly *element) {
+    for (usint t = 0; t < element->GetNumOfElements(); t++) {
+        importCoefficients(in + t * element->GetRingDimension(), &element->ElementAtIndex(t));
+    }
+}
+
+void getRingModuli(const ILDCRTParams<BigInteger> &params, vector<NativeInteger> *moduli, vector<NativeInteger> *rootsOfUnity) {
+    moduli->clear();
+    rootsOfUnity->clear();
+
+    for (auto tower : params.GetParams()) {
+        moduli->push_back(tower->GetModulus());
+        rootsOfUnity->push_back(tower->GetRootOfUnity());
+    }
+}
+
+template <>
+shared_ptr<DCRTPoly::Params> buildRingParams<DCRTPoly>(usint order, const vector<NativeInteger> &moduli, const vector<NativeInteger> &rootsOfUnity) {
+    vector<NativeInteger> towerModuli(moduli);
+    vector<NativeInteger> towerRoots(rootsOfUnity);
+
+    ChineseRemainderTransformFTT<NativeVector>::PreCompute(towerRoots, order, towerModuli);
+    DiscreteFourierTransform::PreComputeTable(order);
+
+    return std::make_shared<ILDCRTParams<BigInteger>>(order, towerModuli, towerRoots);
+}
+
+void addInPlace(NativePoly *a, const NativePoly &b) {
+    checkCompatible(*a, b);
+    if (a->GetLength() > 0) {
+        vectorModAdd(nativeWords(a), nativeWords(b), a->GetLength(), a->GetModulus().ConvertToInt());
+    }
+}
+
+void subInPlace(NativePoly *a, const NativePoly &b) {
+    checkCompatible(*a, b);
+    if (a->GetLength() > 0) {
+        vectorModSub(nativeWords(a), nativeWords(b), a->GetLength(), a->GetModulus().ConvertToInt());
+    }
+}
+
+void addInPlace(DCRTPoly *a, const DCRTPoly &b) {
+    if (a->GetNumOfElements() != b.GetNumOfElements()) {
+        PALISADE_THROW(math_error, "Ring elements with different numbers of towers");
+    }
+    for (usint t = 0; t < a->GetNumOfElements(); t++) {
+        addInPlace(&a->ElementAtIndex(t), b.GetElementAtIndex(t));
+    }
+}
+
+void subInPlace(DCRTPoly *a, const DCRTPoly &b) {
+    if (a->GetNumOfElements() != b.GetNumOfElements()) {
+        PALISADE_THROW(math_error, "Ring elements with different numbers of towers");
+    }
+    for (usint t = 0; t < a->GetNumOfElements(); t++) {
+        subInPlace(&a->ElementAtIndex(t), b.GetElementAtIndex(t));
+    }
+}
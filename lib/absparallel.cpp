@@ -0,0 +1,23 @@
+#include "absparallel.h"
+#include "utils/parallel.h"
+
+namespace {
+
+thread_local usint intraOpThreads = 1;
+
+} // namespace
+
+usint absIntraOpThreads() {
+    return intraOpThreads;
+}
+
+ABSIntraOpScope::ABSIntraOpScope(usint threads) : previous(intraOpThreads) {
+    if (threads == 0) {
+        threads = lbcrypto::PalisadeParallelControls.GetMachineThreads();
+    }
+    intraOpThreads = threads;
+}
+
+ABSIntraOpScope::~ABSIntraOpScope() {
+    intraOpThreads = this->previous;
+}
@@ -0,0 +1,479 @@
+#include "absslab.h"
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <new>
+
+namespace {
+
+// Blocks are aligned as malloc aligns them
+const size_t BLOCK_ALIGNMENT = 16;
+
+// Free blocks of one size shared by all the threads, linked through their
+// first word
+struct GlobalList {
+    std::mutex lock;
+    void *head = nullptr;
+};
+
+// Free blocks of each size kept by one thread. It is trivially destructible,
+// so it can still be reached while the thread exits; once its blocks were
+// handed back, dead sends the frees of the thread to the global lists.
+// flushing is set once the flush at thread exit is registered
+struct ThreadCache {
+    void *head[ABS_SLAB_CLASSES];
+    size_t count[ABS_SLAB_CLASSES];
+    bool flushing;
+    bool dead;
+};
+
+thread_local ThreadCache threadCache;
+
+std::atomic<bool> enabled(false);
+std::atomic<size_t> threadCacheBlocks(256);
+
+// Block sizes, only appended under configLock and published by numClasses
+std::mutex configLock;
+size_t classSizes[ABS_SLAB_CLASSES];
+std::atomic<size_t> numClasses(0);
+
+// Reserved range, set once under configLock
+std::atomic<uintptr_t> regionBase(0);
+std::atomic<size_t> regionBytes(0);
+ABSSlabPages regionPages = ABS_SLAB_PAGES_NONE;
+// Block size class of each slab, written before its blocks are listed
+uint8_t *slabClasses = nullptr;
+std::atomic<size_t> nextSlab(0);
+
+GlobalList globalLists[ABS_SLAB_CLASSES];
+
+std::atomic<uint64_t> refills(0);
+std::atomic<uint64_t> flushes(0);
+std::atomic<uint64_t> exhausted(0);
+
+inline void *&nextBlock(void *block) {
+    return *static_cast<void **>(block);
+}
+
+// Smallest class that fits size without wasting more than half of it, or -1
+int classFor(size_t size) {
+    size_t count = numClasses.load(std::memory_order_acquire);
+    int best = -1;
+
+    for (size_t c = 0; c < count; c++) {
+        if (size <= classSizes[c] && size * 2 > classSizes[c] &&
+            (best < 0 || classSizes[c] < classSizes[best])) {
+            best = static_cast<int>(c);
+        }
+    }
+    return best;
+}
+
+// Prepends a chain of blocks, from first to last, to a global list
+void pushGlobal(size_t c, void *first, void *last) {
+    std::lock_guard<std::mutex> guard(globalLists[c].lock);
+    nextBlock(last) = globalLists[c].head;
+    globalLists[c].head = first;
+}
+
+// Hands the blocks of an exiting thread back to the global lists
+struct CacheFlusher {
+    ~CacheFlusher() {
+        ThreadCache &cache = threadCache;
+
+        for (size_t c = 0; c < ABS_SLAB_CLASSES; c++) {
+            void *first = cache.head[c];
+            if (first == nullptr) {
+                continue;
+            }
+
+            void *last = first;
+            while (nextBlock(last) != nullptr) {
+                last = nextBlock(last);
+            }
+            pushGlobal(c, first, last);
+
+            cache.head[c] = nullptr;
+            cache.count[c] = 0;
+        }
+        cache.dead = true;
+    }
+};
+
+// Registers the flush of the cache at thread exit, before the first block
+// enters it. Both refill and absSlabFree fill the cache, as a thread may only
+// free the blocks of others
+void registerFlush(ThreadCache &cache) {
+    if (!cache.flushing) {
+        static thread_local CacheFlusher flusher;
+        (void)flusher;
+        cache.flushing = true;
+    }
+}
+
+// Splits a new slab into blocks of class c, listed in the global list. The
+// caller holds the list lock. Returns false if the range is full
+bool carveSlab(size_t c) {
+    size_t slabs = regionBytes.load(std::memory_order_acquire) / ABS_SLAB_BYTES;
+    size_t index = nextSlab.fetch_add(1, std::memory_order_relaxed);
+    if (index >= slabs) {
+        return false;
+    }
+
+    slabClasses[index] = static_cast<uint8_t>(c);
+
+    char *slab = reinterpret_cast<char *>(regionBase.load(std::memory_order_acquire)) + index * ABS_SLAB_BYTES;
+    size_t blockSize = classSizes[c];
+    size_t blocks = ABS_SLAB_BYTES / blockSize;
+
+    // Listed from the end, so the blocks are handed out in address order
+    void *head = globalLists[c].head;
+    for (size_t i = blocks; i-- > 0;) {
+        void *block = slab + i * blockSize;
+        nextBlock(block) = head;
+        head = block;
+    }
+    globalLists[c].head = head;
+
+    return true;
+}
+
+// Slow path of absSlabAllocate: takes a batch of blocks from the global list,
+// carving a slab if it is empty, and returns the first one
+void *refill(size_t c) {
+    ThreadCache &cache = threadCache;
+    size_t batch = 1;
+
+    if (!cache.dead) {
+        registerFlush(cache);
+        batch = threadCacheBlocks.load(std::memory_order_relaxed) / 2 + 1;
+    }
+
+    std::lock_guard<std::mutex> guard(globalLists[c].lock);
+    GlobalList &list = globalLists[c];
+
+    if (list.head == nullptr && !carveSlab(c)) {
+        exhausted.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void *block = list.head;
+    list.head = nextBlock(block);
+
+    for (size_t i = 1; i < batch && list.head != nullptr; i++) {
+        void *cached = list.head;
+        list.head = nextBlock(cached);
+
+        nextBlock(cached) = cache.head[c];
+        cache.head[c] = cached;
+        cache.count[c]++;
+    }
+
+    refills.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+// Reserves the range, with huge pages if asked. Called under configLock
+bool reserveRegion(size_t bytes, bool hugePages) {
+    bytes = (bytes + ABS_SLAB_BYTES - 1) / ABS_SLAB_BYTES * ABS_SLAB_BYTES;
+    if (bytes / ABS_SLAB_BYTES == 0) {
+        return false;
+    }
+
+    void *base = MAP_FAILED;
+    ABSSlabPages pages = ABS_SLAB_PAGES_NORMAL;
+
+#ifdef MAP_HUGETLB
+    // Without MAP_NORESERVE the call fails up front, instead of faulting
+    // later, when the system has not reserved enough huge pages
+    if (hugePages) {
+        base = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        pages = ABS_SLAB_PAGES_HUGETLB;
+    }
+#endif
+
+    if (base == MAP_FAILED) {
+        // One slab more, so the range can start on a huge page boundary
+        size_t mapped = bytes + ABS_SLAB_BYTES;
+        void *raw = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (raw == MAP_FAILED) {
+            return false;
+        }
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + ABS_SLAB_BYTES - 1) / ABS_SLAB_BYTES * ABS_SLAB_BYTES;
+        if (aligned > start) {
+            munmap(raw, aligned - start);
+        }
+        if (aligned + bytes < start + mapped) {
+            munmap(reinterpret_cast<void *>(aligned + bytes), start + mapped - aligned - bytes);
+        }
+        base = reinterpret_cast<void *>(aligned);
+        pages = ABS_SLAB_PAGES_NORMAL;
+
+#ifdef MADV_HUGEPAGE
+        if (hugePages && madvise(base, bytes, MADV_HUGEPAGE) == 0) {
+            pages = ABS_SLAB_PAGES_TRANSPARENT_HUGE;
+        }
+#endif
+    }
+
+    // One byte per slab, from calloc so it never goes through operator new
+    slabClasses = static_cast<uint8_t *>(calloc(bytes / ABS_SLAB_BYTES, 1));
+    if (slabClasses == nullptr) {
+        munmap(base, bytes);
+        return false;
+    }
+
+    regionPages = pages;
+    regionBase.store(reinterpret_cast<uintptr_t>(base), std::memory_order_release);
+    regionBytes.store(bytes, std::memory_order_release);
+    return true;
+}
+
+} // namespace
+
+bool absSlabEnable(const ABSSlabConfig &config) {
+#ifndef WITH_ABS_SLAB
+    (void)config;
+    return false;
+#else
+    std::lock_guard<std::mutex> guard(configLock);
+
+    // Sizes are kept aligned, so every block of a slab is
+    size_t sizes[ABS_SLAB_CLASSES];
+    size_t count = numClasses.load(std::memory_order_relaxed);
+    for (size_t c = 0; c < count; c++) {
+        sizes[c] = classSizes[c];
+    }
+
+    for (size_t size : config.blockSizes) {
+        size = (size + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+        if (size < sizeof(void *) || size > ABS_SLAB_BYTES) {
+            return false;
+        }
+
+        bool known = false;
+        for (size_t c = 0; c < count; c++) {
+            known = known || sizes[c] == size;
+        }
+        if (known) {
+            continue;
+        }
+        if (count == ABS_SLAB_CLASSES) {
+            return false;
+        }
+        sizes[count++] = size;
+    }
+
+    if (regionBase.load(std::memory_order_relaxed) == 0 && !reserveRegion(config.reserveBytes, config.hugePages)) {
+        return false;
+    }
+
+    for (size_t c = numClasses.load(std::memory_order_relaxed); c < count; c++) {
+        classSizes[c] = sizes[c];
+    }
+    numClasses.store(count, std::memory_order_release);
+
+    threadCacheBlocks.store(config.threadCacheBlocks, std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_release);
+    return true;
+#endif
+}
+
+void absSlabDisable() {
+    enabled.store(false, std::memory_order_release);
+}
+
+bool absSlabEnabled() {
+    return enabled.load(std::memory_order_acquire);
+}
+
+ABSSlabStats absSlabStats() {
+    ABSSlabStats stats;
+
+    std::lock_guard<std::mutex> guard(configLock);
+    stats.enabled = enabled.load(std::memory_order_relaxed);
+    stats.pages = regionPages;
+
+    size_t count = numClasses.load(std::memory_order_relaxed);
+    stats.blockSizes.assign(classSizes, classSizes + count);
+
+    size_t slabs = regionBytes.load(std::memory_order_relaxed) / ABS_SLAB_BYTES;
+    size_t carved = nextSlab.load(std::memory_order_relaxed);
+    stats.slabs = carved < slabs ? carved : slabs;
+    stats.slabBytes = stats.slabs * ABS_SLAB_BYTES;
+    stats.refills = refills.load(std::memory_order_relaxed);
+    stats.flushes = flushes.load(std::memory_order_relaxed);
+    stats.exhausted = exhausted.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+void *absSlabAllocate(size_t size) {
+    if (!enabled.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+
+    int c = classFor(size);
+    if (c < 0) {
+        return nullptr;
+    }
+
+    ThreadCache &cache = threadCache;
+    void *block = cache.head[c];
+    if (block != nullptr) {
+        cache.head[c] = nextBlock(block);
+        cache.count[c]--;
+        return block;
+    }
+
+    return refill(c);
+}
+
+bool absSlabOwns(const void *ptr) {
+    // The size is published after the base, so a range seen as reserved
+    // always has its base
+    size_t bytes = regionBytes.load(std::memory_order_acquire);
+    uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - regionBase.load(std::memory_order_relaxed);
+    return offset < bytes;
+}
+
+void absSlabFree(void *ptr) {
+    uintptr_t offset = reinterpret_cast<uintptr_t>(ptr) - regionBase.load(std::memory_order_relaxed);
+    size_t c = slabClasses[offset / ABS_SLAB_BYTES];
+
+    ThreadCache &cache = threadCache;
+    if (cache.dead) {
+        pushGlobal(c, ptr, ptr);
+        return;
+    }
+
+    registerFlush(cache);
+    nextBlock(ptr) = cache.head[c];
+    cache.head[c] = ptr;
+
+    // A thread that frees what others allocate, as the writer of a pipeline,
+    // would otherwise hoard the blocks. Half of them go back in one batch
+    size_t limit = threadCacheBlocks.load(std::memory_order_relaxed);
+    if (++cache.count[c] > limit) {
+        size_t keep = limit / 2;
+        void *last = cache.head[c];
+        for (size_t i = 1; i < keep; i++) {
+            last = nextBlock(last);
+        }
+
+        void *first = keep == 0 ? cache.head[c] : nextBlock(last);
+        if (keep == 0) {
+            cache.head[c] = nullptr;
+        } else {
+            nextBlock(last) = nullptr;
+        }
+
+        void *tail = first;
+        while (nextBlock(tail) != nullptr) {
+            tail = nextBlock(tail);
+        }
+        pushGlobal(c, first, tail);
+
+        cache.count[c] = keep;
+        flushes.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+size_t absResidentBytes() {
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+        return 0;
+    }
+
+    unsigned long size = 0, resident = 0;
+    int fields = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+
+    return fields == 2 ? size_t(resident) * size_t(sysconf(_SC_PAGESIZE)) : 0;
+}
+
+size_t absPeakResidentBytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    // Linux reports it in KiB
+    return size_t(usage.ru_maxrss) * 1024;
+}
+
+#ifdef WITH_ABS_SLAB
+
+// Replacements of the global allocation functions: the sizes served by the
+// slabs go there once enabled, everything else to malloc
+
+static void *mallocOrThrow(std::size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    for (;;) {
+        void *ptr = malloc(size);
+        if (ptr != nullptr) {
+            return ptr;
+        }
+
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void *operator new(std::size_t size) {
+    void *ptr = absSlabAllocate(size);
+    return ptr != nullptr ? ptr : mallocOrThrow(size);
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return ::operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *ptr) noexcept {
+    if (absSlabOwns(ptr)) {
+        absSlabFree(ptr);
+    } else {
+        free(ptr);
+    }
+}
+
+void operator delete[](void *ptr) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    ::operator delete(ptr);
+}
+
+#endif
@@ -0,0 +1,221 @@
+#include "absstats.h"
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <sstream>
+
+static const char *const phaseNames[ABS_PHASE_COUNT] = {
+    "attribute-hash",
+    "attribute-syndrome",
+    "preimage-sampling",
+    "gaussian-sampling",
+    "ntt",
+    "public-product",
+    "tag-secret",
+    "tag-message",
+    "key-accumulation",
+    "syndrome-accumulation",
+    "subset-sum-build",
+    "gpv-keygen",
+    "gpv-sign",
+    "gpv-sample-offline",
+    "gpv-sign-online",
+    "gpv-verify",
+    "extract",
+    "sign",
+    "sign-batch",
+    "verify",
+    "verify-batch"
+};
+
+namespace {
+
+// Counters of a single thread. Only the owning thread records into them, but
+// absStatsReset clears them from another thread, so the counts are updated
+// with relaxed fetch_add and a reset is never undone by a record in flight.
+// The line stays with its owner, so the adds are uncontended
+struct ThreadStats {
+    std::atomic<uint64_t> calls[ABS_PHASE_COUNT];
+    std::atomic<uint64_t> totalNs[ABS_PHASE_COUNT];
+    std::atomic<uint64_t> maxNs[ABS_PHASE_COUNT];
+    std::atomic<uint64_t> histogram[ABS_PHASE_COUNT][ABS_STATS_BUCKETS];
+
+    ThreadStats() {
+        clear();
+    }
+
+    void clear() {
+        for (size_t p = 0; p < ABS_PHASE_COUNT; p++) {
+            this->calls[p].store(0, std::memory_order_relaxed);
+            this->totalNs[p].store(0, std::memory_order_relaxed);
+            this->maxNs[p].store(0, std::memory_order_relaxed);
+            for (size_t b = 0; b < ABS_STATS_BUCKETS; b++) {
+                this->histogram[p][b].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void addTo(ABSStatsSnapshot *snapshot) const {
+        for (size_t p = 0; p < ABS_PHASE_COUNT; p++) {
+            ABSPhaseStats &stats = snapshot->phases[p];
+            uint64_t maxNs = this->maxNs[p].load(std::memory_order_relaxed);
+
+            stats.calls += this->calls[p].load(std::memory_order_relaxed);
+            stats.totalNs += this->totalNs[p].load(std::memory_order_relaxed);
+            stats.maxNs = maxNs > stats.maxNs ? maxNs : stats.maxNs;
+            for (size_t b = 0; b < ABS_STATS_BUCKETS; b++) {
+                stats.histogram[b] += this->histogram[p][b].load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Every live thread that recorded something, and the sum of the ones gone
+struct StatsRegistry {
+    std::mutex lock;
+    std::set<ThreadStats *> threads;
+    ABSStatsSnapshot retired;
+};
+
+// Never destroyed, as threads may still record while the program exits
+StatsRegistry &registry() {
+    static StatsRegistry *instance = [] {
+        StatsRegistry *r = new StatsRegistry();
+        memset(&r->retired, 0, sizeof(r->retired));
+        return r;
+    }();
+    return *instance;
+}
+
+// Registers the counters of a thread on its first record, and folds them
+// into the retired sum when the thread exits
+class ThreadSlot {
+    public:
+        ThreadSlot() {
+            std::lock_guard<std::mutex> guard(registry().lock);
+            registry().threads.insert(&this->stats);
+        }
+
+        ~ThreadSlot() {
+            std::lock_guard<std::mutex> guard(registry().lock);
+            this->stats.addTo(&registry().retired);
+            registry().threads.erase(&this->stats);
+        }
+
+        ThreadStats stats;
+};
+
+// Histogram bucket of a duration
+size_t bucketOf(uint64_t ns) {
+    size_t bucket = ns == 0 ? 0 : 63 - __builtin_clzll(ns);
+    return bucket < ABS_STATS_BUCKETS ? bucket : ABS_STATS_BUCKETS - 1;
+}
+
+void increment(std::atomic<uint64_t> *counter, uint64_t value) {
+    counter->fetch_add(value, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+const char *absPhaseName(ABSPhase phase) {
+    return phase < ABS_PHASE_COUNT ? phaseNames[phase] : "unknown";
+}
+
+void absStatsRecord(ABSPhase phase, uint64_t ns) {
+    static thread_local ThreadSlot slot;
+    ThreadStats &stats = slot.stats;
+
+    size_t bucket = bucketOf(ns);
+
+    increment(&stats.calls[phase], 1);
+    increment(&stats.totalNs[phase], ns);
+    increment(&stats.histogram[phase][bucket], 1);
+
+    // Only the owner stores the maximum, so a reset between the load and the
+    // store can at most leave this record, never an older one
+    if (ns > stats.maxNs[phase].load(std::memory_order_relaxed)) {
+        stats.maxNs[phase].store(ns, std::memory_order_relaxed);
+    }
+}
+
+void absStatsAdd(ABSPhaseStats *stats, uint64_t ns) {
+    stats->calls++;
+    stats->totalNs += ns;
+    stats->maxNs = ns > stats->maxNs ? ns : stats->maxNs;
+    stats->histogram[bucketOf(ns)]++;
+}
+
+ABSStatsSnapshot absStatsSnapshot() {
+    StatsRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+
+    ABSStatsSnapshot snapshot = r.retired;
+#ifdef WITH_ABS_STATS
+    snapshot.enabled = true;
+#else
+    snapshot.enabled = false;
+#endif
+
+    for (ThreadStats *stats : r.threads) {
+        stats->addTo(&snapshot);
+    }
+
+    return snapshot;
+}
+
+void absStatsReset() {
+    StatsRegistry &r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+
+    memset(&r.retired, 0, sizeof(r.retired));
+    for (ThreadStats *stats : r.threads) {
+        stats->clear();
+    }
+}
+
+uint64_t absStatsPercentile(const ABSPhaseStats &stats, double fraction) {
+    if (stats.calls == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(fraction * stats.calls);
+    uint64_t seen = 0;
+
+    for (size_t b = 0; b < ABS_STATS_BUCKETS; b++) {
+        seen += stats.histogram[b];
+        if (seen > target || b == ABS_STATS_BUCKETS - 1) {
+            return b == ABS_STATS_BUCKETS - 1 ? stats.maxNs : (uint64_t(2) << b) - 1;
+        }
+    }
+
+    return stats.maxNs;
+}
+
+std::string absStatsJson(const ABSStatsSnapshot &snapshot) {
+    std::ostringstream out;
+
+    out << "{\"enabled\": " << (snapshot.enabled ? "true" : "false") << ", \"phases\": [";
+    for (size_t p = 0; p < ABS_PHASE_COUNT; p++) {
+        const ABSPhaseStats &stats = snapshot.phases[p];
+
+        out << (p ? ", " : "") << "{\"phase\": \"" << phaseNames[p] << "\", \"calls\": " << stats.calls
+            << ", \"total_ns\": " << stats.totalNs << ", \"max_ns\": " << stats.maxNs
+            << ", \"p50_ns\": " << absStatsPercentile(stats, 0.5)
+            << ", \"p90_ns\": " << absStatsPercentile(stats, 0.9)
+            << ", \"p99_ns\": " << absStatsPercentile(stats, 0.99) << ", \"histogram\": [";
+
+        // Trailing empty buckets are left out
+        size_t used = ABS_STATS_BUCKETS;
+        while (used > 0 && stats.histogram[used - 1] == 0) {
+            used--;
+        }
+        for (size_t b = 0; b < used; b++) {
+            out << (b ? ", " : "") << stats.histogram[b];
+        }
+        out << "]}";
+    }
+    out << "]}";
+
+    return out.str();
+}
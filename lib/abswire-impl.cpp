@@ -0,0 +1,18 @@
+// Forward definition of the signature wire format for each supported ring element
+
+#include "abswire.cpp"
+#include "abswire.h"
+
+#define ABSWIRE_INSTANTIATE(Element)                                                          \
+    template vector<uint8_t> serializeSignature<Element>(const signatureABS<Element> &);      \
+    template void parseSignature<Element>(                                                    \
+        shared_ptr<GPVSignatureParameters<Element>>, const uint8_t *, size_t,                 \
+        SignatureWireView *);                                                                 \
+    template signatureABS<Element> decodeSignature<Element>(                                  \
+        shared_ptr<GPVSignatureParameters<Element>>, const SignatureWireView &);              \
+    template signatureABS<Element> deserializeSignature<Element>(                             \
+        shared_ptr<GPVSignatureParameters<Element>>, const uint8_t *, size_t);
+
+ABSWIRE_INSTANTIATE(Poly)
+ABSWIRE_INSTANTIATE(NativePoly)
+ABSWIRE_INSTANTIATE(DCRTPoly)
@@ -0,0 +1,181 @@
+#ifndef _SRC_LIB_ABSWIRE_CPP
+#define _SRC_LIB_ABSWIRE_CPP
+
+#include "abswire.h"
+#include "abselement.h"
+#include "ricecoding.h"
+#include <string.h>
+
+template <class Element>
+vector<uint8_t> serializeSignature(const signatureABS<Element> &signature) {
+    vector<uint8_t> out(ABS_WIRE_MAGIC, ABS_WIRE_MAGIC + sizeof(ABS_WIRE_MAGIC));
+
+    out.push_back(ABS_WIRE_VERSION);
+    out.push_back(static_cast<uint8_t>(signature.getTagEncoding()));
+    out.push_back(static_cast<uint8_t>(signature.getHashMode()));
+
+    uint32_t tag = signature.getSignatureHash();
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(tag >> shift));
+    }
+
+    const vector<string> &attributes = signature.getAttributeList();
+    writeVarint(attributes.size(), &out);
+    for (auto i = attributes.begin(); i != attributes.end(); ++i) {
+        writeVarint(i->size(), &out);
+        out.insert(out.end(), i->begin(), i->end());
+    }
+
+    // Gather the centered coefficients of every polynomial of z
+    const Matrix<Element> &z = signature.getSignature();
+    usint ringDimension = z(0, 0).GetRingDimension();
+
+    vector<uint64_t> values;
+    values.reserve(z.GetRows() * z.GetCols() * ringDimension);
+    vector<int64_t> centered;
+
+    for (size_t r = 0; r < z.GetRows(); r++) {
+        for (size_t c = 0; c < z.GetCols(); c++) {
+            Element element = z(r, c);
+            if (element.GetFormat() == EVALUATION) {
+                element.SwitchFormat();
+            }
+
+            getCenteredCoefficients(element, &centered);
+            for (auto value : centered) {
+                values.push_back(zigzagEncode(value));
+            }
+        }
+    }
+
+    uint8_t parameter = riceParameter(values);
+    vector<uint8_t> stream;
+    riceEncode(values, parameter, &stream);
+
+    writeVarint(z.GetRows(), &out);
+    writeVarint(z.GetCols(), &out);
+    writeVarint(ringDimension, &out);
+    out.push_back(parameter);
+    writeVarint(stream.size(), &out);
+    out.insert(out.end(), stream.begin(), stream.end());
+
+    return out;
+}
+
+// Reads a varint that must fit 32 bits
+static bool readVarint32(const uint8_t *data, size_t size, size_t *offset, usint *value) {
+    uint64_t wide;
+    if (!readVarint(data, size, offset, &wide) || wide > 0xFFFFFFFFULL) {
+        return false;
+    }
+    *value = static_cast<usint>(wide);
+    return true;
+}
+
+template <class Element>
+void parseSignature(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                    const uint8_t *data, size_t size,
+                    SignatureWireView *view) {
+    size_t offset = sizeof(ABS_WIRE_MAGIC) + 3 + 4;
+
+    if (size < offset || memcmp(data, ABS_WIRE_MAGIC, sizeof(ABS_WIRE_MAGIC)) != 0) {
+        PALISADE_THROW(deserialize_error, "Not an encoded ABS signature");
+    }
+
+    view->version = data[3];
+    if (view->version != ABS_WIRE_VERSION) {
+        PALISADE_THROW(deserialize_error, "Unsupported ABS signature version");
+    }
+
+    if (data[4] > TAG_ENCODING_BINARY || data[5] > ATTRIBUTE_HASH_SHAKE128) {
+        PALISADE_THROW(deserialize_error, "Unknown tag encoding or attribute hash mode");
+    }
+    view->tagEncoding = static_cast<TagEncoding>(data[4]);
+    view->hashMode = static_cast<AttributeHashMode>(data[5]);
+    view->tag = (uint32_t(data[6]) << 24) | (uint32_t(data[7]) << 16) |
+                (uint32_t(data[8]) << 8) | uint32_t(data[9]);
+
+    usint numAttributes;
+    if (!readVarint32(data, size, &offset, &numAttributes)) {
+        PALISADE_THROW(deserialize_error, "Truncated ABS signature");
+    }
+
+    view->attributes.clear();
+    for (usint i = 0; i < numAttributes; i++) {
+        uint64_t length;
+        if (!readVarint(data, size, &offset, &length) || length > size - offset) {
+            PALISADE_THROW(deserialize_error, "Truncated ABS signature");
+        }
+        view->attributes.emplace_back(reinterpret_cast<const char *>(data + offset), length);
+        offset += length;
+    }
+
+    uint64_t streamSize;
+    if (!readVarint32(data, size, &offset, &view->rows) ||
+        !readVarint32(data, size, &offset, &view->cols) ||
+        !readVarint32(data, size, &offset, &view->ringDimension) ||
+        offset >= size) {
+        PALISADE_THROW(deserialize_error, "Truncated ABS signature");
+    }
+    view->riceParameter = data[offset++];
+
+    if (!readVarint(data, size, &offset, &streamSize) || streamSize != size - offset) {
+        PALISADE_THROW(deserialize_error, "Truncated ABS signature");
+    }
+    view->coefficients = data + offset;
+    view->coefficientsSize = streamSize;
+
+    // z is the preimage of a 1 x m verification key
+    const usint m = m_params->GetK() + 2;
+    if (view->ringDimension != m_params->GetILParams()->GetRingDimension() ||
+        view->rows != m || view->cols != 1 || view->riceParameter > 63) {
+        PALISADE_THROW(deserialize_error, "ABS signature does not match the parameters");
+    }
+}
+
+template <class Element>
+signatureABS<Element> decodeSignature(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                      const SignatureWireView &view) {
+    shared_ptr<typename Element::Params> params = m_params->GetILParams();
+    auto zero_alloc = Element::Allocator(params, COEFFICIENT);
+
+    size_t perElement = view.ringDimension;
+    size_t count = size_t(view.rows) * view.cols * perElement;
+
+    vector<uint64_t> values(count);
+    if (!riceDecode(view.coefficients, view.coefficientsSize, view.riceParameter, values.data(), count)) {
+        PALISADE_THROW(deserialize_error, "Truncated ABS signature coefficients");
+    }
+
+    // The zigzag values are mapped back in place
+    int64_t *centered = reinterpret_cast<int64_t *>(values.data());
+    for (size_t i = 0; i < count; i++) {
+        centered[i] = zigzagDecode(values[i]);
+    }
+
+    Matrix<Element> z(zero_alloc, view.rows, view.cols);
+    for (size_t r = 0; r < view.rows; r++) {
+        for (size_t c = 0; c < view.cols; c++) {
+            setCenteredCoefficients(centered + (r * view.cols + c) * perElement, &z(r, c));
+        }
+    }
+    z.SwitchFormat();
+
+    vector<string> attributes;
+    attributes.reserve(view.attributes.size());
+    for (auto i = view.attributes.begin(); i != view.attributes.end(); ++i) {
+        attributes.emplace_back(i->first, i->second);
+    }
+
+    return signatureABS<Element>(attributes, view.tag, z, view.tagEncoding, view.hashMode);
+}
+
+template <class Element>
+signatureABS<Element> deserializeSignature(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                           const uint8_t *data, size_t size) {
+    SignatureWireView view;
+    parseSignature(m_params, data, size, &view);
+    return decodeSignature(m_params, view);
+}
+
+#endif
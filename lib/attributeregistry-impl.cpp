@@ -0,0 +1,6 @@
+#include "attributeregistry.cpp"
+#include "attributeregistry.h"
+
+template class AttributeRegistry<Poly>;
+template class AttributeRegistry<NativePoly>;
+template class AttributeRegistry<DCRTPoly>;
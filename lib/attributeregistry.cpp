@@ -0,0 +1,150 @@
+#ifndef _SRC_LIB_ATTRIBUTEREGISTRY_CPP
+#define _SRC_LIB_ATTRIBUTEREGISTRY_CPP
+
+#include "attributeregistry.h"
+#include "abselement.h"
+#include "absparallel.h"
+#include "utils/parallel.h"
+
+template <class Element>
+AttributeRegistry<Element>::AttributeRegistry(shared_ptr<GPVSignatureParameters<Element>> m_params,
+                                              const vector<string> &attributes,
+                                              AttributeHashMode hashMode,
+                                              usint numThreads)
+    : params(m_params->GetILParams()), hashMode(hashMode), names(attributes) {
+
+    for (size_t i = 0; i < this->names.size(); i++) {
+        if (!this->ids.emplace(this->names[i], static_cast<AttributeId>(i)).second) {
+            PALISADE_THROW(config_error, "Attribute registered twice: " + this->names[i]);
+        }
+    }
+
+    if (numThreads == 0) {
+        numThreads = PalisadeParallelControls.GetMachineThreads();
+    }
+
+    // The attributes are independent, so their syndromes are split among the
+    // workers, each one writing its own slice of the table
+    int count = static_cast<int>(this->names.size());
+    this->table.resize(this->names.size() * 32);
+
+#pragma omp parallel for schedule(dynamic) num_threads(numThreads)
+    for (int i = 0; i < count; i++) {
+        shared_ptr<const typename AttributeSyndromeCache<Element>::SyndromeRow> row =
+            attributeSyndrome(this->names[i], m_params, hashMode);
+
+        for (int j = 0; j < 32; j++) {
+            this->table[size_t(i) * 32 + j] = (*row)[j];
+        }
+    }
+}
+
+template <class Element>
+const string &AttributeRegistry<Element>::getName(AttributeId id) const {
+    if (id >= this->names.size()) {
+        PALISADE_THROW(config_error, "Unknown attribute id");
+    }
+    return this->names[id];
+}
+
+template <class Element>
+vector<string> AttributeRegistry<Element>::getNames(const vector<AttributeId> &ids) const {
+    vector<string> result;
+    result.reserve(ids.size());
+
+    for (auto id : ids) {
+        result.push_back(getName(id));
+    }
+    return result;
+}
+
+template <class Element>
+bool AttributeRegistry<Element>::find(const string &attribute, AttributeId *id) const {
+    auto it = this->ids.find(attribute);
+    if (it == this->ids.end()) {
+        return false;
+    }
+
+    *id = it->second;
+    return true;
+}
+
+template <class Element>
+bool AttributeRegistry<Element>::findAll(const vector<string> &attributes, vector<AttributeId> *ids) const {
+    ids->resize(attributes.size());
+
+    for (size_t i = 0; i < attributes.size(); i++) {
+        if (!find(attributes[i], &(*ids)[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Element>
+vector<AttributeId> AttributeRegistry<Element>::getIds(const vector<string> &attributes) const {
+    vector<AttributeId> result(attributes.size());
+
+    for (size_t i = 0; i < attributes.size(); i++) {
+        if (!find(attributes[i], &result[i])) {
+            PALISADE_THROW(config_error, "Unknown attribute: " + attributes[i]);
+        }
+    }
+    return result;
+}
+
+template <class Element>
+bool AttributeRegistry<Element>::matches(const vector<AttributeId> &ids, const vector<string> &attributes) const {
+    if (ids.size() != attributes.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (ids[i] >= this->names.size() || this->names[ids[i]] != attributes[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Element>
+void AttributeRegistry<Element>::checkIds(const vector<AttributeId> &ids) const {
+    for (auto id : ids) {
+        if (id >= this->names.size()) {
+            PALISADE_THROW(config_error, "Unknown attribute id");
+        }
+    }
+}
+
+template <class Element>
+void AttributeRegistry<Element>::syndromeMatrix(const vector<AttributeId> &ids, Matrix<Element> *syndromeMatrix) const {
+    checkIds(ids);
+
+    // Each tag bit is its own column of the matrix, so the bits can be split
+    // among the intra-operation workers
+    usint threads = absIntraOpThreads();
+
+#pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (int j = 0; j < 32; j++) {
+        for (auto id : ids) {
+            addInPlace(&(*syndromeMatrix)(0, j), this->table[size_t(id) * 32 + j]);
+        }
+    }
+}
+
+template <class Element>
+void AttributeRegistry<Element>::accumulate(const vector<AttributeId> &ids, uint32_t h, Element *sum) const {
+    checkIds(ids);
+
+    // Only the bits set in the tag are read, so a single signature costs
+    // fewer additions than building the whole syndrome matrix first
+    for (int j = 0; j < 32; j++) {
+        if ((h >> (31 - j)) & 0x1) {
+            for (auto id : ids) {
+                addInPlace(sum, this->table[size_t(id) * 32 + j]);
+            }
+        }
+    }
+}
+
+#endif
@@ -36,4 +36,18 @@ template class GPVSignatureScheme<Poly>;
 template class GPVSignature<Poly>;
 template class GPVPlaintext<Poly>;
 
+template class GPVSignatureParameters<NativePoly>;
+template class GPVSignKey<NativePoly>;
+template class GPVVerificationKey<NativePoly>;
+template class GPVSignatureScheme<NativePoly>;
+template class GPVSignature<NativePoly>;
+template class GPVPlaintext<NativePoly>;
+
+template class GPVSignatureParameters<DCRTPoly>;
+template class GPVSignKey<DCRTPoly>;
+template class GPVVerificationKey<DCRTPoly>;
+template class GPVSignatureScheme<DCRTPoly>;
+template class GPVSignature<DCRTPoly>;
+template class GPVPlaintext<DCRTPoly>;
+
 }  // namespace lbcrypto
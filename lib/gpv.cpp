@@ -33,6 +33,7 @@
 #define _SRC_LIB_CRYPTO_SIGNATURE_LWESIGN_CPP
 
 #include "gpv.h"
+#include "absstats.h"
 #include <ios>
 #include <iostream>
 #include <ostream>
@@ -46,6 +47,7 @@ namespace lbcrypto {
   void GPVSignatureScheme<Element>::KeyGen(
     shared_ptr<LPSignatureParameters<Element>> sparams, LPSignKey<Element> *sk,
     LPVerificationKey<Element> *vk) {
+    ABS_STATS_PHASE(ABS_PHASE_GPV_KEYGEN);
     auto *signKey = static_cast<GPVSignKey<Element> *>(sk);
     auto *verificationKey = static_cast<GPVVerificationKey<Element> *>(vk);
     auto m_params =
@@ -74,13 +76,18 @@ namespace lbcrypto {
       std::make_shared<RLWETrapdoorPair<Element>>(keyPair.second));
     size_t n = params->GetRingDimension();
     if (n > 32) {
+      // The PRNG is private to each thread. The new bytes are added to a copy
+      // of the seed, which then replaces the one signers read
+      std::lock_guard<std::mutex> guard(seedMutex);
+      auto newSeed = std::make_shared<std::vector<char>>(*seed);
       for (size_t i = 0; i < n - 32; i = i + 4) {
         int rand = (PseudoRandomNumberGenerator::GetPRNG())();
-        seed.push_back((rand >> 24) & 0xFF);
-        seed.push_back((rand >> 16) & 0xFF);
-        seed.push_back((rand >> 8) & 0xFF);
-        seed.push_back((rand)&0xFF);
+        newSeed->push_back((rand >> 24) & 0xFF);
+        newSeed->push_back((rand >> 16) & 0xFF);
+        newSeed->push_back((rand >> 8) & 0xFF);
+        newSeed->push_back((rand)&0xFF);
       }
+      seed = newSeed;
     }
   }
 
@@ -90,6 +97,7 @@ namespace lbcrypto {
     shared_ptr<LPSignatureParameters<Element>> sparams,
     const LPSignKey<Element> &sk, const LPVerificationKey<Element> &vk,
     const LPSignPlaintext<Element> &pt, LPSignature<Element> *sign) {
+    ABS_STATS_PHASE(ABS_PHASE_GPV_SIGN);
     auto m_params =
       std::static_pointer_cast<GPVSignatureParameters<Element>>(sparams);
     const auto &signKey = static_cast<const GPVSignKey<Element> &>(sk);
@@ -120,10 +128,11 @@ namespace lbcrypto {
     // generator to use in sampling
     const Matrix<Element> &A = verificationKey.GetVerificationKey();
     const RLWETrapdoorPair<Element> &T = signKey.GetSignKey();
-    typename Element::DggType &dgg = m_params->GetDiscreteGaussianGenerator();
+    typename Element::DggType &dgg =
+      m_params->GetThreadDiscreteGaussianGenerator();
 
     typename Element::DggType &dggLargeSigma =
-      m_params->GetDiscreteGaussianGeneratorLargeSigma();
+      m_params->GetThreadDiscreteGaussianGeneratorLargeSigma();
     Matrix<Element> zHat = RLWETrapdoorUtility<Element>::GaussSamp(
       n, k, A, T, u, dgg, dggLargeSigma, base);
     signatureText->SetSignature(std::make_shared<Matrix<Element>>(zHat));
@@ -134,6 +143,7 @@ namespace lbcrypto {
   PerturbationVector<Element> GPVSignatureScheme<Element>::SampleOffline(
     shared_ptr<LPSignatureParameters<Element>> s_params,
     const LPSignKey<Element> &ssignKey) {
+    ABS_STATS_PHASE(ABS_PHASE_GPV_SAMPLE_OFFLINE);
     auto m_params =
       std::static_pointer_cast<GPVSignatureParameters<Element>>(s_params);
     const auto &signKey = static_cast<const GPVSignKey<Element> &>(ssignKey);
@@ -144,9 +154,10 @@ namespace lbcrypto {
 
     // Getting the trapdoor and gaussian generatorw to use in sampling
     const RLWETrapdoorPair<Element> &T = signKey.GetSignKey();
-    typename Element::DggType &dgg = m_params->GetDiscreteGaussianGenerator();
+    typename Element::DggType &dgg =
+      m_params->GetThreadDiscreteGaussianGenerator();
     typename Element::DggType &dggLargeSigma =
-      m_params->GetDiscreteGaussianGeneratorLargeSigma();
+      m_params->GetThreadDiscreteGaussianGeneratorLargeSigma();
 
     return PerturbationVector<Element>(
       RLWETrapdoorUtility<Element>::GaussSampOffline(n, k, T, dgg,
@@ -160,6 +171,7 @@ namespace lbcrypto {
     const LPSignKey<Element> &sk, const LPVerificationKey<Element> &vk,
     const PerturbationVector<Element> &perturbationVector,
     const LPSignPlaintext<Element> &pt, LPSignature<Element> *ssignatureText) {
+    ABS_STATS_PHASE(ABS_PHASE_GPV_SIGN_ONLINE);
     auto m_params =
       std::static_pointer_cast<GPVSignatureParameters<Element>>(sparams);
     const auto &signKey = static_cast<const GPVSignKey<Element> &>(sk);
@@ -183,7 +195,13 @@ namespace lbcrypto {
     HashUtil::Hash(plainText.GetPlaintext(), SHA_256, digest);
 
     if (plainText.GetPlaintext().size() <= n) {
-      for (size_t i = 0; i < n - 32; i = i + 4) digest.push_back(seed[i]);
+      shared_ptr<const std::vector<char>> currentSeed;
+      {
+        std::lock_guard<std::mutex> guard(seedMutex);
+        currentSeed = seed;
+      }
+      for (size_t i = 0; i < n - 32; i = i + 4)
+        digest.push_back((*currentSeed)[i]);
     }
 
     hashedText =
@@ -197,7 +215,8 @@ namespace lbcrypto {
     // generator to use in sampling
     const Matrix<Element> &A = verificationKey.GetVerificationKey();
     const RLWETrapdoorPair<Element> &T = signKey.GetSignKey();
-    typename Element::DggType &dgg = m_params->GetDiscreteGaussianGenerator();
+    typename Element::DggType &dgg =
+      m_params->GetThreadDiscreteGaussianGenerator();
 
     Matrix<Element> zHat = RLWETrapdoorUtility<Element>::GaussSampOnline(
       n, k, A, T, u, dgg, perturbationVector.GetVector(), base);
@@ -210,6 +229,7 @@ namespace lbcrypto {
     shared_ptr<LPSignatureParameters<Element>> sparams,
     const LPVerificationKey<Element> &vk, const LPSignature<Element> &sign,
     const LPSignPlaintext<Element> &pt) {
+    ABS_STATS_PHASE(ABS_PHASE_GPV_VERIFY);
     auto m_params =
       std::static_pointer_cast<GPVSignatureParameters<Element>>(sparams);
     const auto &verificationKey =
@@ -0,0 +1,12 @@
+// @file keystore-impl.cpp - Forward declarations for KeyStore
+
+#include "keystore.cpp"
+#include "keystore.h"
+
+namespace lbcrypto {
+
+template class KeyStore<Poly>;
+template class KeyStore<NativePoly>;
+template class KeyStore<DCRTPoly>;
+
+}  // namespace lbcrypto
@@ -0,0 +1,219 @@
+// @file keystore.cpp - Implementation of the memory mapped key store
+
+#ifndef _SRC_LIB_SIGNATURE_KEYSTORE_CPP
+#define _SRC_LIB_SIGNATURE_KEYSTORE_CPP
+
+#include "keystore.h"
+#include "abselement.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <vector>
+
+namespace lbcrypto {
+
+// Sections start on cache line boundaries
+static uint64_t KeyStoreAlign(uint64_t offset) { return (offset + 63) & ~uint64_t(63); }
+
+// Writes a matrix of polynomials, each polynomial taking wordsPerPoly words
+template <class Element>
+static void KeyStoreWriteMatrix(const Matrix<Element>& matrix,
+                                size_t wordsPerPoly, uint64_t* out) {
+  for (size_t r = 0; r < matrix.GetRows(); r++)
+    for (size_t c = 0; c < matrix.GetCols(); c++) {
+      const Element& element = matrix(r, c);
+      if (element.GetFormat() != EVALUATION)
+        PALISADE_THROW(serialize_error, "Keys must be in EVALUATION format");
+      exportCoefficients(element, out);
+      out += wordsPerPoly;
+    }
+}
+
+// True if a section of count items of wordsPerItem words starting at offset
+// is word aligned and fits in a file of size bytes. Every product is bounded
+// by a division first, so a hostile header can not wrap around
+static bool KeyStoreFits(uint64_t offset, uint64_t count, uint64_t wordsPerItem, uint64_t size) {
+  if (offset % 8 != 0 || offset > size) return false;
+  uint64_t words = (size - offset) / 8;
+  return wordsPerItem == 0 || count <= words / wordsPerItem;
+}
+
+template <class Element>
+void KeyStore<Element>::Write(const string& path,
+                              shared_ptr<GPVSignatureParameters<Element>> params,
+                              const GPVVerificationKey<Element>& vk,
+                              const GPVSignKey<Element>* sk) {
+  shared_ptr<typename Element::Params> ilParams = params->GetILParams();
+  vector<NativeInteger> moduli, rootsOfUnity;
+  getRingModuli(*ilParams, &moduli, &rootsOfUnity);
+
+  const Matrix<Element>& A = vk.GetVerificationKey();
+
+  KeyStoreHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, KEYSTORE_MAGIC, sizeof(header.magic));
+  header.version = KEYSTORE_VERSION;
+  header.byteOrder = KEYSTORE_BYTE_ORDER;
+  header.cyclotomicOrder = ilParams->GetCyclotomicOrder();
+  header.ringDimension = ilParams->GetRingDimension();
+  header.numTowers = moduli.size();
+  header.base = params->GetBase();
+  header.k = params->GetK();
+  header.flags = sk != nullptr ? KEYSTORE_HAS_SIGN_KEY : 0;
+  header.stddev = params->GetDiscreteGaussianGenerator().GetStd();
+  header.vkRows = A.GetRows();
+  header.vkCols = A.GetCols();
+
+  size_t wordsPerPoly = size_t(header.numTowers) * header.ringDimension;
+  uint64_t vkWords = uint64_t(header.vkRows) * header.vkCols * wordsPerPoly;
+  uint64_t skWords = 0;
+  if (sk != nullptr) {
+    const RLWETrapdoorPair<Element>& T = sk->GetSignKey();
+    header.skRows = T.m_r.GetRows();
+    header.skCols = T.m_r.GetCols();
+    skWords = 2 * uint64_t(header.skRows) * header.skCols * wordsPerPoly;
+  }
+
+  header.moduliOffset = KeyStoreAlign(sizeof(header));
+  header.rootsOffset = KeyStoreAlign(header.moduliOffset + 8 * header.numTowers);
+  header.verificationKeyOffset = KeyStoreAlign(header.rootsOffset + 8 * header.numTowers);
+  header.signKeyOffset = KeyStoreAlign(header.verificationKeyOffset + 8 * vkWords);
+  header.fileSize = header.signKeyOffset + 8 * skWords;
+
+  // Assemble the whole file in words, the offsets being multiples of 8
+  vector<uint64_t> file(header.fileSize / 8, 0);
+  memcpy(file.data(), &header, sizeof(header));
+  for (size_t t = 0; t < moduli.size(); t++) {
+    file[header.moduliOffset / 8 + t] = moduli[t].ConvertToInt();
+    file[header.rootsOffset / 8 + t] = rootsOfUnity[t].ConvertToInt();
+  }
+  KeyStoreWriteMatrix(A, wordsPerPoly, &file[header.verificationKeyOffset / 8]);
+  if (sk != nullptr) {
+    const RLWETrapdoorPair<Element>& T = sk->GetSignKey();
+    uint64_t* out = &file[header.signKeyOffset / 8];
+    KeyStoreWriteMatrix(T.m_r, wordsPerPoly, out);
+    KeyStoreWriteMatrix(T.m_e, wordsPerPoly, out + skWords / 2);
+  }
+
+  string tmpPath = path + ".tmp";
+  {
+    std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+    stream.write(reinterpret_cast<const char*>(file.data()), header.fileSize);
+    if (!stream.good())
+      PALISADE_THROW(serialize_error, "Cannot write the key store " + tmpPath);
+  }
+  if (rename(tmpPath.c_str(), path.c_str()) != 0)
+    PALISADE_THROW(serialize_error, "Cannot replace the key store " + path);
+}
+
+template <class Element>
+KeyStore<Element>::KeyStore(const string& path) : m_data(nullptr), m_size(0) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) PALISADE_THROW(deserialize_error, "Cannot open the key store " + path);
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(KeyStoreHeader)) {
+    close(fd);
+    PALISADE_THROW(deserialize_error, "Truncated key store " + path);
+  }
+  m_size = st.st_size;
+  m_data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (m_data == MAP_FAILED) {
+    m_data = nullptr;
+    PALISADE_THROW(deserialize_error, "Cannot map the key store " + path);
+  }
+  m_header = static_cast<const KeyStoreHeader*>(m_data);
+
+  // Every later read goes through the sections the header describes, so the
+  // ring shape, the key shapes (1 x (k+2) and k columns for each half of the
+  // trapdoor) and the bounds of each section are checked before any of them
+  const KeyStoreHeader& header = *m_header;
+  uint64_t wordsPerPoly = uint64_t(header.numTowers) * header.ringDimension;
+  bool valid =
+      memcmp(header.magic, KEYSTORE_MAGIC, sizeof(header.magic)) == 0 &&
+      header.version == KEYSTORE_VERSION &&
+      header.byteOrder == KEYSTORE_BYTE_ORDER && header.fileSize == m_size &&
+      header.numTowers > 0 && header.ringDimension > 0 &&
+      uint64_t(header.ringDimension) * 2 == header.cyclotomicOrder &&
+      header.vkRows == 1 && uint64_t(header.vkCols) == uint64_t(header.k) + 2 &&
+      KeyStoreFits(header.moduliOffset, header.numTowers, 1, m_size) &&
+      KeyStoreFits(header.rootsOffset, header.numTowers, 1, m_size) &&
+      KeyStoreFits(header.verificationKeyOffset, header.vkCols, wordsPerPoly, m_size) &&
+      (!HasSignKey() ||
+       (header.skRows == 1 && header.skCols == header.k &&
+        KeyStoreFits(header.signKeyOffset, 2 * uint64_t(header.skCols), wordsPerPoly, m_size)));
+  if (!valid) {
+    munmap(m_data, m_size);
+    m_data = nullptr;
+    PALISADE_THROW(deserialize_error, "Invalid key store " + path);
+  }
+
+  vector<NativeInteger> moduli(header.numTowers), rootsOfUnity(header.numTowers);
+  for (uint32_t t = 0; t < header.numTowers; t++) {
+    moduli[t] = NativeInteger(Section(header.moduliOffset)[t]);
+    rootsOfUnity[t] = NativeInteger(Section(header.rootsOffset)[t]);
+  }
+
+  // The destructor does not run if the constructor throws
+  try {
+    auto ilParams = buildRingParams<Element>(header.cyclotomicOrder, moduli, rootsOfUnity);
+    typename Element::DggType dgg(header.stddev);
+    m_params = std::make_shared<GPVSignatureParameters<Element>>(ilParams, dgg, header.base);
+    if (m_params->GetK() != header.k)
+      PALISADE_THROW(deserialize_error, "Key store gadget length does not match its modulus");
+    m_verificationKey = std::make_shared<Matrix<Element>>(
+        LoadMatrix(GetVerificationKeyData(), header.vkRows, header.vkCols));
+  } catch (...) {
+    munmap(m_data, m_size);
+    m_data = nullptr;
+    throw;
+  }
+}
+
+template <class Element>
+KeyStore<Element>::~KeyStore() {
+  if (m_data != nullptr) munmap(m_data, m_size);
+}
+
+template <class Element>
+Matrix<Element> KeyStore<Element>::LoadMatrix(const uint64_t* words,
+                                              uint32_t rows,
+                                              uint32_t cols) const {
+  auto zero_alloc = Element::Allocator(m_params->GetILParams(), EVALUATION);
+  size_t wordsPerPoly = size_t(m_header->numTowers) * m_header->ringDimension;
+
+  Matrix<Element> matrix(zero_alloc, rows, cols);
+  for (uint32_t r = 0; r < rows; r++)
+    for (uint32_t c = 0; c < cols; c++) {
+      importCoefficients(words, &matrix(r, c));
+      words += wordsPerPoly;
+    }
+  return matrix;
+}
+
+template <class Element>
+void KeyStore<Element>::LoadVerificationKey(GPVVerificationKey<Element>* vk) const {
+  vk->SetVerificationKey(m_verificationKey);
+}
+
+template <class Element>
+void KeyStore<Element>::LoadSignKey(GPVSignKey<Element>* sk) const {
+  if (!HasSignKey()) PALISADE_THROW(config_error, "The key store holds no sign key");
+
+  size_t polys = size_t(m_header->skRows) * m_header->skCols;
+  const uint64_t* words = Section(m_header->signKeyOffset);
+  size_t half = polys * m_header->numTowers * m_header->ringDimension;
+
+  Matrix<Element> r = LoadMatrix(words, m_header->skRows, m_header->skCols);
+  Matrix<Element> e = LoadMatrix(words + half, m_header->skRows, m_header->skCols);
+  sk->SetSignKey(std::make_shared<RLWETrapdoorPair<Element>>(r, e));
+}
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,86 @@
+#include "messagesource.h"
+#include "utils/exception.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+size_t MemoryMessageSource::next(const uint8_t **chunk) {
+    size_t length = this->size;
+
+    *chunk = this->data;
+    this->data += length;
+    this->size = 0;
+
+    return length;
+}
+
+size_t StreamMessageSource::next(const uint8_t **chunk) {
+    this->stream.read(reinterpret_cast<char *>(this->buffer.data()), this->buffer.size());
+    if (this->stream.bad()) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Cannot read the message stream");
+    }
+
+    *chunk = this->buffer.data();
+    return static_cast<size_t>(this->stream.gcount());
+}
+
+size_t FileDescriptorMessageSource::next(const uint8_t **chunk) {
+    ssize_t length;
+
+    do {
+        length = read(this->fd, this->buffer.data(), this->buffer.size());
+    } while (length < 0 && errno == EINTR);
+
+    if (length < 0) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Cannot read the message file descriptor");
+    }
+
+    *chunk = this->buffer.data();
+    return static_cast<size_t>(length);
+}
+
+MappedFileMessageSource::MappedFileMessageSource(const std::string &path, size_t chunkSize)
+    : mapping(nullptr), size(0), offset(0), chunkSize(chunkSize) {
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Cannot open the message " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        PALISADE_THROW(lbcrypto::deserialize_error, "Cannot read the size of the message " + path);
+    }
+    this->size = st.st_size;
+
+    // Empty files can not be mapped, and there is nothing to hand out anyway
+    if (this->size > 0) {
+        this->mapping = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (this->mapping == MAP_FAILED) {
+            this->mapping = nullptr;
+            close(fd);
+            PALISADE_THROW(lbcrypto::deserialize_error, "Cannot map the message " + path);
+        }
+        madvise(this->mapping, this->size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+}
+
+MappedFileMessageSource::~MappedFileMessageSource() {
+    if (this->mapping != nullptr) {
+        munmap(this->mapping, this->size);
+    }
+}
+
+size_t MappedFileMessageSource::next(const uint8_t **chunk) {
+    size_t length = std::min(this->chunkSize, this->size - this->offset);
+
+    *chunk = static_cast<const uint8_t *>(this->mapping) + this->offset;
+    this->offset += length;
+
+    return length;
+}
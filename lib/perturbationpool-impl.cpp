@@ -0,0 +1,12 @@
+// @file perturbationpool-impl.cpp - Forward declarations for PerturbationPool
+
+#include "perturbationpool.cpp"
+#include "perturbationpool.h"
+
+namespace lbcrypto {
+
+template class PerturbationPool<Poly>;
+template class PerturbationPool<NativePoly>;
+template class PerturbationPool<DCRTPoly>;
+
+}  // namespace lbcrypto
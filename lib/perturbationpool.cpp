@@ -0,0 +1,40 @@
+// @file perturbationpool.cpp - Implementation of the perturbation vector pool
+
+#ifndef _SRC_LIB_SIGNATURE_PERTURBATIONPOOL_CPP
+#define _SRC_LIB_SIGNATURE_PERTURBATIONPOOL_CPP
+
+#include "perturbationpool.h"
+
+namespace lbcrypto {
+
+  template <class Element>
+  PerturbationPool<Element>::PerturbationPool(
+    shared_ptr<GPVSignatureParameters<Element>> params,
+    const GPVSignKey<Element> &signKey, const PrecomputePoolConfig &config)
+    : m_params(params), m_signKey(signKey),
+      m_pool([this]() { return MakeProducer(); }, config) {}
+
+  template <class Element>
+  typename PrecomputePool<shared_ptr<Matrix<Element>>>::Producer
+  PerturbationPool<Element>::MakeProducer() {
+    // Getting parameters for calculations
+    size_t n = m_params->GetILParams()->GetRingDimension();
+    size_t k = m_params->GetK();
+    size_t base = m_params->GetBase();
+
+    // Each producer samples with its own gaussian generators, so the workers
+    // never share sampler state
+    auto dgg = std::make_shared<typename Element::DggType>(
+      m_params->GetDiscreteGaussianGenerator());
+    auto dggLargeSigma = std::make_shared<typename Element::DggType>(
+      m_params->GetDiscreteGaussianGeneratorLargeSigma());
+    GPVSignKey<Element> signKey = m_signKey;
+
+    return [n, k, base, dgg, dggLargeSigma, signKey]() {
+      return RLWETrapdoorUtility<Element>::GaussSampOffline(
+        n, k, signKey.GetSignKey(), *dgg, *dggLargeSigma, base);
+    };
+  }
+
+}  // namespace lbcrypto
+#endif
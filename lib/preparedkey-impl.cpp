@@ -0,0 +1,12 @@
+// @file preparedkey-impl.cpp - Forward declarations for PreparedVerificationKey
+
+#include "preparedkey.cpp"
+#include "preparedkey.h"
+
+namespace lbcrypto {
+
+template class PreparedVerificationKey<Poly>;
+template class PreparedVerificationKey<NativePoly>;
+template class PreparedVerificationKey<DCRTPoly>;
+
+}  // namespace lbcrypto
@@ -0,0 +1,187 @@
+// @file preparedkey.cpp - Implementation of the prepared verification key
+
+#ifndef _SRC_LIB_SIGNATURE_PREPAREDKEY_CPP
+#define _SRC_LIB_SIGNATURE_PREPAREDKEY_CPP
+
+#include "preparedkey.h"
+#include "abselement.h"
+#include "absparallel.h"
+#include "simdkernels.h"
+#include <algorithm>
+
+namespace lbcrypto {
+
+template <class Element>
+PreparedVerificationKey<Element>::PreparedVerificationKey(
+    shared_ptr<GPVSignatureParameters<Element>> params,
+    const GPVVerificationKey<Element>& vk)
+    : m_params(params->GetILParams()), m_vk(vk), m_hasKey(true) {
+  const Matrix<Element>& A = vk.GetVerificationKey();
+  if (A.GetRows() != 1)
+    PALISADE_THROW(math_error, "Only 1 x m verification keys can be prepared");
+
+  vector<NativeInteger> moduli, rootsOfUnity;
+  getRingModuli(*m_params, &moduli, &rootsOfUnity);
+
+  m_ringDimension = m_params->GetRingDimension();
+  m_towers = moduli.size();
+  m_cols = A.GetCols();
+  for (auto& q : moduli) m_moduli.push_back(q.ConvertToInt());
+
+  size_t words = size_t(m_towers) * m_ringDimension;
+  m_ownedValues.resize(words * m_cols);
+  for (usint j = 0; j < m_cols; j++) {
+    if (A(0, j).GetFormat() != EVALUATION)
+      PALISADE_THROW(math_error, "The verification key must be in EVALUATION format");
+    exportCoefficients(A(0, j), &m_ownedValues[j * words]);
+  }
+  m_values = m_ownedValues.data();
+
+  Precompute();
+}
+
+template <class Element>
+PreparedVerificationKey<Element>::PreparedVerificationKey(
+    const KeyStore<Element>& store)
+    : m_params(store.GetParams()->GetILParams()), m_hasKey(true) {
+  store.LoadVerificationKey(&m_vk);
+  const KeyStoreHeader& header = store.GetHeader();
+  if (header.vkRows != 1)
+    PALISADE_THROW(math_error, "Only 1 x m verification keys can be prepared");
+
+  vector<NativeInteger> moduli, rootsOfUnity;
+  getRingModuli(*m_params, &moduli, &rootsOfUnity);
+
+  m_ringDimension = header.ringDimension;
+  m_towers = header.numTowers;
+  m_cols = header.vkCols;
+  for (auto& q : moduli) m_moduli.push_back(q.ConvertToInt());
+
+  // The store already has the layout used here
+  m_values = store.GetVerificationKeyData();
+
+  Precompute();
+}
+
+template <class Element>
+bool PreparedVerificationKey<Element>::IsSupported(
+    shared_ptr<typename Element::Params> params) {
+  vector<NativeInteger> moduli, rootsOfUnity;
+  try {
+    getRingModuli(*params, &moduli, &rootsOfUnity);
+  } catch (const math_error&) {
+    return false;
+  }
+  for (auto& q : moduli)
+    if (q.GetMSB() > 62) return false;
+  return true;
+}
+
+template <class Element>
+void PreparedVerificationKey<Element>::Precompute() {
+  for (auto q : m_moduli)
+    if (q >> 62)
+      PALISADE_THROW(math_error, "Prepared keys need moduli below 2^62");
+
+  size_t words = size_t(m_towers) * m_ringDimension;
+  m_shoup.resize(words * m_cols);
+
+  for (usint j = 0; j < m_cols; j++)
+    for (usint t = 0; t < m_towers; t++) {
+      size_t offset = j * words + t * m_ringDimension;
+      unsigned __int128 q = m_moduli[t];
+      for (usint i = 0; i < m_ringDimension; i++)
+        m_shoup[offset + i] =
+            static_cast<uint64_t>((unsigned __int128)m_values[offset + i] << 64) / q;
+    }
+}
+
+template <class Element>
+Element PreparedVerificationKey<Element>::Multiply(const Matrix<Element>& z) const {
+  Element result(m_params, EVALUATION, true);
+  vector<uint64_t> scratch;
+  Multiply(z, &result, &scratch);
+  return result;
+}
+
+template <class Element>
+void PreparedVerificationKey<Element>::AccumulateColumn(const Matrix<Element>& z, usint j, uint64_t* sum,
+                                                        uint64_t* column) const {
+  size_t words = size_t(m_towers) * m_ringDimension;
+  exportCoefficients(z(j, 0), column);
+
+  for (usint t = 0; t < m_towers; t++) {
+    size_t offset = j * words + t * m_ringDimension;
+    const uint64_t* a = m_values + offset;
+    const uint64_t* aShoup = m_shoup.data() + offset;
+    const uint64_t* x = column + t * m_ringDimension;
+    uint64_t* s = sum + t * m_ringDimension;
+
+    // Shoup's product x*a - floor(x*a'/2^64)*q is in [0, 2q), and the
+    // running sum is kept in [0, 2q) as well
+    vectorShoupMulAcc(s, x, a, aShoup, m_ringDimension, m_moduli[t]);
+  }
+}
+
+template <class Element>
+void PreparedVerificationKey<Element>::Multiply(const Matrix<Element>& z, Element* result,
+                                                vector<uint64_t>* scratch) const {
+  if (z.GetRows() != m_cols || z.GetCols() != 1)
+    PALISADE_THROW(math_error, "The vector does not match the prepared key");
+
+  for (usint j = 0; j < m_cols; j++)
+    if (z(j, 0).GetFormat() != EVALUATION)
+      PALISADE_THROW(math_error, "The vector must be in EVALUATION format");
+
+  // The running sum and the current column share the scratch words, followed
+  // by a sum and a column per intra-operation worker. The vector only grows,
+  // so a scratch reused with the same workers is not allocated again
+  usint threads = absIntraOpThreads();
+  usint workers = threads > 1 && m_cols > 1 ? threads : 0;
+  size_t words = size_t(m_towers) * m_ringDimension;
+  scratch->resize(2 * words * (1 + workers));
+  uint64_t* sum = scratch->data();
+  uint64_t* column = sum + words;
+  std::fill(sum, sum + words, 0);
+
+  if (workers > 0) {
+    // Each worker sums a slice of the columns apart, and the sums reduced to
+    // [0, q) are added in order to the shared one, kept in [0, q) as well
+#pragma omp parallel for schedule(static, 1) num_threads(threads)
+    for (int w = 0; w < static_cast<int>(workers); w++) {
+      uint64_t* local = sum + 2 * words * (1 + w);
+      std::fill(local, local + words, 0);
+      for (usint j = m_cols * w / workers; j < m_cols * (w + 1) / workers; j++)
+        AccumulateColumn(z, j, local, local + words);
+    }
+
+    for (usint w = 0; w < workers; w++) {
+      const uint64_t* local = sum + 2 * words * (1 + w);
+      for (usint t = 0; t < m_towers; t++) {
+        uint64_t q = m_moduli[t];
+        uint64_t* s = sum + t * m_ringDimension;
+        const uint64_t* l = local + t * m_ringDimension;
+        for (usint i = 0; i < m_ringDimension; i++) {
+          uint64_t x = l[i] >= q ? l[i] - q : l[i];
+          s[i] += x;
+          if (s[i] >= q) s[i] -= q;
+        }
+      }
+    }
+  } else {
+    for (usint j = 0; j < m_cols; j++) AccumulateColumn(z, j, sum, column);
+  }
+
+  for (usint t = 0; t < m_towers; t++) {
+    uint64_t q = m_moduli[t];
+    uint64_t* s = sum + t * m_ringDimension;
+    for (usint i = 0; i < m_ringDimension; i++)
+      if (s[i] >= q) s[i] -= q;
+  }
+
+  importCoefficients(sum, result);
+}
+
+}  // namespace lbcrypto
+
+#endif
@@ -0,0 +1,191 @@
+#include "ricecoding.h"
+
+namespace {
+
+// Writes bits least significant first, filling each byte from its low bit
+class BitWriter {
+    public:
+        explicit BitWriter(vector<uint8_t> *out) : out(out), pending(0), used(0) {}
+
+        void write(uint64_t bits, uint32_t count) {
+            // At most 7 bits are pending, so 32 more always fit the word
+            if (count > 32) {
+                write(bits, 32);
+                write(bits >> 32, count - 32);
+                return;
+            }
+
+            this->pending |= (bits & ((uint64_t(1) << count) - 1)) << this->used;
+            this->used += count;
+
+            while (this->used >= 8) {
+                this->out->push_back(static_cast<uint8_t>(this->pending));
+                this->pending >>= 8;
+                this->used -= 8;
+            }
+        }
+
+        void writeOnes(uint32_t count) {
+            while (count > 0) {
+                uint32_t chunk = count < 32 ? count : 32;
+                write(~uint64_t(0), chunk);
+                count -= chunk;
+            }
+        }
+
+        void flush() {
+            if (this->used > 0) {
+                this->out->push_back(static_cast<uint8_t>(this->pending));
+                this->pending = 0;
+                this->used = 0;
+            }
+        }
+
+    private:
+        vector<uint8_t> *out;
+        uint64_t pending;
+        uint32_t used;
+};
+
+class BitReader {
+    public:
+        BitReader(const uint8_t *data, size_t size)
+            : data(data), size(size), offset(0), pending(0), available(0) {}
+
+        bool read(uint32_t count, uint64_t *bits) {
+            if (count > 32) {
+                uint64_t low, high;
+                if (!read(32, &low) || !read(count - 32, &high)) {
+                    return false;
+                }
+                *bits = low | (high << 32);
+                return true;
+            }
+
+            while (this->available < count) {
+                if (this->offset == this->size) {
+                    return false;
+                }
+                this->pending |= uint64_t(this->data[this->offset++]) << this->available;
+                this->available += 8;
+            }
+
+            *bits = this->pending & ((uint64_t(1) << count) - 1);
+            this->pending >>= count;
+            this->available -= count;
+            return true;
+        }
+
+    private:
+        const uint8_t *data;
+        size_t size;
+        // Next byte to be loaded
+        size_t offset;
+        uint64_t pending;
+        uint32_t available;
+};
+
+}  // namespace
+
+void writeVarint(uint64_t value, vector<uint8_t> *out) {
+    while (value >= 0x80) {
+        out->push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const uint8_t *data, size_t size, size_t *offset, uint64_t *value) {
+    uint64_t result = 0;
+
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (*offset >= size) {
+            return false;
+        }
+
+        uint8_t byte = data[(*offset)++];
+        result |= uint64_t(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint8_t riceParameter(const vector<uint64_t> &values) {
+    if (values.empty()) {
+        return 0;
+    }
+
+    // The best parameter is about log2 of the mean value
+    double sum = 0;
+    for (auto value : values) {
+        sum += static_cast<double>(value);
+    }
+    double mean = sum / values.size();
+
+    uint8_t parameter = 0;
+    while (parameter < 63 && mean >= 2.0) {
+        mean /= 2;
+        parameter++;
+    }
+
+    return parameter;
+}
+
+void riceEncode(const vector<uint64_t> &values, uint8_t parameter, vector<uint8_t> *out) {
+    BitWriter writer(out);
+
+    for (auto value : values) {
+        uint64_t quotient = value >> parameter;
+
+        if (quotient >= RICE_ESCAPE) {
+            writer.writeOnes(RICE_ESCAPE);
+            writer.write(value, 64);
+            continue;
+        }
+
+        writer.writeOnes(static_cast<uint32_t>(quotient));
+        writer.write(0, 1);
+        writer.write(value, parameter);
+    }
+
+    writer.flush();
+}
+
+bool riceDecode(const uint8_t *data, size_t size, uint8_t parameter, uint64_t *values, size_t count) {
+    BitReader reader(data, size);
+
+    for (size_t i = 0; i < count; i++) {
+        uint64_t quotient = 0;
+        uint64_t bit = 1;
+
+        while (quotient < RICE_ESCAPE) {
+            if (!reader.read(1, &bit)) {
+                return false;
+            }
+            if (bit == 0) {
+                break;
+            }
+            quotient++;
+        }
+
+        if (quotient == RICE_ESCAPE) {
+            if (!reader.read(64, &values[i])) {
+                return false;
+            }
+            continue;
+        }
+
+        uint64_t remainder;
+        if (!reader.read(parameter, &remainder)) {
+            return false;
+        }
+        values[i] = (quotient << parameter) | remainder;
+    }
+
+    return true;
+}
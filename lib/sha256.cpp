@@ -0,0 +1,126 @@
+#include "sha256.h"
+#include <string.h>
+
+namespace {
+
+const uint32_t roundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+}  // namespace
+
+void SHA256::reset() {
+    this->state[0] = 0x6a09e667;
+    this->state[1] = 0xbb67ae85;
+    this->state[2] = 0x3c6ef372;
+    this->state[3] = 0xa54ff53a;
+    this->state[4] = 0x510e527f;
+    this->state[5] = 0x9b05688c;
+    this->state[6] = 0x1f83d9ab;
+    this->state[7] = 0x5be0cd19;
+    this->bufferLength = 0;
+    this->totalLength = 0;
+}
+
+void SHA256::update(const void *data, size_t len) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    this->totalLength += len;
+
+    // Complete a partially filled block first
+    if (this->bufferLength > 0) {
+        size_t missing = 64 - this->bufferLength;
+        size_t copied = len < missing ? len : missing;
+
+        memcpy(this->buffer + this->bufferLength, bytes, copied);
+        this->bufferLength += copied;
+        bytes += copied;
+        len -= copied;
+
+        if (this->bufferLength < 64) {
+            return;
+        }
+        compress(this->buffer);
+        this->bufferLength = 0;
+    }
+
+    // Full blocks are compressed straight from the input
+    for (; len >= 64; bytes += 64, len -= 64) {
+        compress(bytes);
+    }
+
+    memcpy(this->buffer, bytes, len);
+    this->bufferLength = len;
+}
+
+void SHA256::final(uint8_t digest[DIGEST_SIZE]) {
+    uint64_t bitLength = this->totalLength * 8;
+    uint8_t padding[72] = {0x80};
+    size_t paddingLength = (this->bufferLength < 56 ? 56 : 120) - this->bufferLength;
+
+    for (int i = 0; i < 8; i++) {
+        padding[paddingLength + i] = static_cast<uint8_t>(bitLength >> (56 - 8 * i));
+    }
+    update(padding, paddingLength + 8);
+
+    for (int i = 0; i < 8; i++) {
+        digest[4 * i] = static_cast<uint8_t>(this->state[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(this->state[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(this->state[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(this->state[i]);
+    }
+}
+
+void SHA256::compress(const uint8_t block[64]) {
+    uint32_t w[64];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = (uint32_t(block[4 * i]) << 24) | (uint32_t(block[4 * i + 1]) << 16) |
+               (uint32_t(block[4 * i + 2]) << 8) | uint32_t(block[4 * i + 3]);
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = this->state[0], b = this->state[1], c = this->state[2], d = this->state[3];
+    uint32_t e = this->state[4], f = this->state[5], g = this->state[6], h = this->state[7];
+
+    for (int i = 0; i < 64; i++) {
+        uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + roundConstants[i] + w[i];
+        uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    this->state[0] += a;
+    this->state[1] += b;
+    this->state[2] += c;
+    this->state[3] += d;
+    this->state[4] += e;
+    this->state[5] += f;
+    this->state[6] += g;
+    this->state[7] += h;
+}
@@ -0,0 +1,117 @@
+#include "shake128.h"
+#include <string.h>
+
+namespace {
+
+const uint64_t roundConstants[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+// Rotation offsets and lane order of the combined rho and pi steps
+const int rotations[24] = {
+    1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44
+};
+
+const int lanes[24] = {
+    10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1
+};
+
+inline uint64_t rotl(uint64_t x, int n) {
+    return (x << n) | (x >> (64 - n));
+}
+
+}  // namespace
+
+void SHAKE128::reset() {
+    memset(this->state, 0, sizeof(this->state));
+    this->position = 0;
+    this->squeezing = false;
+}
+
+// Lanes are little-endian, whatever the byte order of the host
+void SHAKE128::xorByte(size_t position, uint8_t value) {
+    this->state[position / 8] ^= uint64_t(value) << (8 * (position % 8));
+}
+
+uint8_t SHAKE128::getByte(size_t position) const {
+    return static_cast<uint8_t>(this->state[position / 8] >> (8 * (position % 8)));
+}
+
+void SHAKE128::update(const void *data, size_t len) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+    for (size_t i = 0; i < len; i++) {
+        xorByte(this->position++, bytes[i]);
+
+        if (this->position == RATE) {
+            permute();
+            this->position = 0;
+        }
+    }
+}
+
+void SHAKE128::squeeze(void *out, size_t len) {
+    uint8_t *bytes = static_cast<uint8_t *>(out);
+
+    // Pad the input the first time: SHAKE domain bits, then pad10*1
+    if (!this->squeezing) {
+        xorByte(this->position, 0x1F);
+        xorByte(RATE - 1, 0x80);
+        permute();
+        this->position = 0;
+        this->squeezing = true;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        if (this->position == RATE) {
+            permute();
+            this->position = 0;
+        }
+        bytes[i] = getByte(this->position++);
+    }
+}
+
+// Keccak-f[1600]
+void SHAKE128::permute() {
+    uint64_t *a = this->state;
+    uint64_t c[5];
+
+    for (int round = 0; round < 24; round++) {
+        // theta
+        for (int x = 0; x < 5; x++) {
+            c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+        }
+        for (int x = 0; x < 5; x++) {
+            uint64_t d = c[(x + 4) % 5] ^ rotl(c[(x + 1) % 5], 1);
+            for (int y = 0; y < 25; y += 5) {
+                a[y + x] ^= d;
+            }
+        }
+
+        // rho and pi
+        uint64_t current = a[1];
+        for (int i = 0; i < 24; i++) {
+            uint64_t next = a[lanes[i]];
+            a[lanes[i]] = rotl(current, rotations[i]);
+            current = next;
+        }
+
+        // chi
+        for (int y = 0; y < 25; y += 5) {
+            for (int x = 0; x < 5; x++) {
+                c[x] = a[y + x];
+            }
+            for (int x = 0; x < 5; x++) {
+                a[y + x] = c[x] ^ (~c[(x + 1) % 5] & c[(x + 2) % 5]);
+            }
+        }
+
+        // iota
+        a[0] ^= roundConstants[round];
+    }
+}
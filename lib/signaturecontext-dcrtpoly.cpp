@@ -0,0 +1,58 @@
+// @file signaturecontext-dcrtpoly.cpp - RNS specialization of SignatureContext
+
+#include <algorithm>
+#include <cmath>
+#include "signaturecontext.h"
+
+namespace lbcrypto {
+
+// Largest tower handed to FirstPrime; the prime found has one bit more and
+// must stay below the 60 bits supported by NativeInteger
+#define DCRT_MAX_TOWER_BITS 59
+
+// Method for setting up a GPV context over DCRTPoly. The towers all get the
+// same width, a whole number of gadget digits, so the trapdoor sampler splits
+// the gadget evenly between them
+template <>
+void SignatureContext<DCRTPoly>::GenerateGPVContext(usint ringsize, usint bits,
+                                                    usint base) {
+  usint sm = ringsize * 2;
+  double stddev = SIGMA;
+  DCRTPoly::DggType dgg(stddev);
+
+  usint digitBits = std::max<usint>(1, std::floor(std::log2(base)));
+  usint numTowers = (bits + DCRT_MAX_TOWER_BITS - 1) / DCRT_MAX_TOWER_BITS;
+  usint towerBits;
+  while (true) {
+    towerBits = (bits + numTowers - 1) / numTowers;
+    towerBits = ((towerBits + digitBits - 1) / digitBits) * digitBits;
+    if (towerBits <= DCRT_MAX_TOWER_BITS) break;
+    numTowers++;
+  }
+
+  vector<NativeInteger> moduli(numTowers);
+  vector<NativeInteger> rootsOfUnity(numTowers);
+
+  NativeInteger q = FirstPrime<NativeInteger>(towerBits, sm);
+  for (usint i = 0; i < numTowers; i++) {
+    if (i > 0) q = NextPrime<NativeInteger>(q, sm);
+    moduli[i] = q;
+    rootsOfUnity[i] = RootOfUnity<NativeInteger>(sm, q);
+  }
+
+  ChineseRemainderTransformFTT<NativeVector>::PreCompute(rootsOfUnity, sm, moduli);
+  DiscreteFourierTransform::PreComputeTable(sm);
+
+  auto silparams = std::make_shared<ILDCRTParams<BigInteger>>(sm, moduli, rootsOfUnity);
+  m_params = std::make_shared<GPVSignatureParameters<DCRTPoly>>(silparams, dgg, base);
+  m_scheme = std::make_shared<GPVSignatureScheme<DCRTPoly>>();
+  // Syndromes depend on the ring parameters, so drop the ones cached before
+  m_syndromeCache = std::make_shared<AttributeSyndromeCache<DCRTPoly>>(m_syndromeCacheCapacity);
+  m_perturbationPool.reset();
+  m_signingPool.reset();
+  m_preparedKey.reset();
+  ResetSubsetSumTables();
+  ResetAttributeRegistry();
+}
+
+}  // namespace lbcrypto
@@ -27,6 +27,8 @@
 namespace lbcrypto {
 template class SignatureContext<Poly>;
 
-// template class SignatureContext<NativePoly>;
+template class SignatureContext<NativePoly>;
+
+template class SignatureContext<DCRTPoly>;
 
 }  // namespace lbcrypto
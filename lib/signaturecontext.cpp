@@ -23,6 +23,9 @@
 
 #include "signaturecontext.h"
 #include "abs.h"
+#include "abselement.h"
+#include "absparallel.h"
+#include "absstats.h"
 #include "math/matrix.h"
 
 namespace lbcrypto {
@@ -46,6 +49,13 @@ namespace lbcrypto {
     auto silparams = std::make_shared<ILParamsImpl<typename Element::Integer>>(ilParams);
     m_params = std::make_shared<GPVSignatureParameters<Element>>(silparams, dgg, base);
     m_scheme = std::make_shared<GPVSignatureScheme<Element>>();
+    // Syndromes depend on the ring parameters, so drop the ones cached before
+    m_syndromeCache = std::make_shared<AttributeSyndromeCache<Element>>(m_syndromeCacheCapacity);
+    m_perturbationPool.reset();
+    m_signingPool.reset();
+    m_preparedKey.reset();
+    ResetSubsetSumTables();
+    ResetAttributeRegistry();
   }
 
   // Method for setting up a GPV context with desired security level only
@@ -61,12 +71,50 @@ namespace lbcrypto {
         k = 27;
         base = 64;
         break;
+      case 2048:
+        k = 30;
+        base = 32;
+        break;
+      case 4096:
+        k = 32;
+        base = 16;
+        break;
       default:
         PALISADE_THROW(config_error, "Unknown ringsize");
     }
     GenerateGPVContext(ringsize, k, base);
   }
 
+  // Method for setting up a GPV context from a key store
+  template <class Element>
+  void SignatureContext<Element>::GenerateGPVContext(const KeyStore<Element>& store) {
+    m_params = store.GetParams();
+    m_scheme = std::make_shared<GPVSignatureScheme<Element>>();
+    m_syndromeCache = std::make_shared<AttributeSyndromeCache<Element>>(m_syndromeCacheCapacity);
+    m_perturbationPool.reset();
+    m_signingPool.reset();
+    ResetSubsetSumTables();
+    ResetAttributeRegistry();
+
+    // The prepared key reads the mapped words of the store, so the verifier
+    // processes mapping it share the pages of the key
+    m_preparedKey.reset();
+    if (store.GetHeader().vkRows == 1 &&
+        PreparedVerificationKey<Element>::IsSupported(store.GetParams()->GetILParams()))
+      m_preparedKey = std::make_shared<PreparedVerificationKey<Element>>(store);
+  }
+
+  // Method for saving the parameters and keys
+  template <class Element>
+  void SignatureContext<Element>::SaveKeyStore(const string& path,
+                                               const LPVerificationKey<Element>& vk,
+                                               const LPSignKey<Element>* sk) const {
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    KeyStore<Element>::Write(path, params,
+                             static_cast<const GPVVerificationKey<Element>&>(vk),
+                             static_cast<const GPVSignKey<Element>*>(sk));
+  }
+
   // Method for key generation
   template <class Element>
   void SignatureContext<Element>::KeyGen(LPSignKey<Element>* sk,
@@ -74,6 +122,23 @@ namespace lbcrypto {
     m_scheme->KeyGen(m_params, sk, vk);
   }
 
+  // Method for signing a given plaintext
+  template <class Element>
+  void SignatureContext<Element>::Sign(const LPSignPlaintext<Element>& pt,
+                                       const LPSignKey<Element>& sk,
+                                       const LPVerificationKey<Element>& vk,
+                                       LPSignature<Element>* signatureText) {
+    m_scheme->Sign(m_params, sk, vk, pt, signatureText);
+  }
+
+  // Method for verifying a given plaintext and signature
+  template <class Element>
+  bool SignatureContext<Element>::Verify(const LPSignPlaintext<Element>& pt,
+                                         const LPSignature<Element>& signature,
+                                         const LPVerificationKey<Element>& vk) {
+    return m_scheme->Verify(m_params, vk, signature, pt);
+  }
+
   // Method for offline phase of signing a given plaintext
   template <class Element>
   void SignatureContext<Element>::SignOfflinePhase(
@@ -90,45 +155,442 @@ namespace lbcrypto {
     m_scheme->SignOnline(m_params, sk, vk, pv, pt, signatureText);
   }
 
+  // Method for online phase of signing using a pooled perturbation vector
+  template <class Element>
+  void SignatureContext<Element>::SignOnlinePhase(
+    const LPSignPlaintext<Element>& pt, const LPSignKey<Element>& sk,
+    const LPVerificationKey<Element>& vk, LPSignature<Element>* signatureText) {
+    const auto &signKey = static_cast<const GPVSignKey<Element> &>(sk);
+
+    if (m_perturbationPool == nullptr || !m_perturbationPool->IsBoundTo(signKey))
+      PALISADE_THROW(config_error, "No perturbation pool enabled for this sign key");
+
+    PerturbationVector<Element> pv(m_perturbationPool->Take());
+    m_scheme->SignOnline(m_params, sk, vk, pv, pt, signatureText);
+  }
+
+  // Method for precomputing perturbation vectors in background
+  template <class Element>
+  void SignatureContext<Element>::EnablePerturbationPool(
+    const LPSignKey<Element>& sk, const PrecomputePoolConfig& config) {
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &signKey = static_cast<const GPVSignKey<Element> &>(sk);
+
+    // Stop the workers of the previous pool before starting the new ones
+    m_perturbationPool.reset();
+    m_perturbationPool = std::make_shared<PerturbationPool<Element>>(params, signKey, config);
+  }
+
+  // Method for precomputing signature nonces in background
+  template <class Element>
+  void SignatureContext<Element>::EnableSigningPool(
+    const LPVerificationKey<Element>& vk, const PrecomputePoolConfig& config) {
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    shared_ptr<const PreparedVerificationKey<Element>> prepared;
+    if (m_preparedKey != nullptr && m_preparedKey->IsBoundTo(verificationKey))
+      prepared = m_preparedKey;
+
+    // Stop the workers of the previous pool before starting the new ones
+    m_signingPool.reset();
+    m_signingPool = std::make_shared<SigningPool<Element>>(params, verificationKey, m_tagEncoding,
+                                                           prepared, config);
+  }
+
   // Method for key generation
   template <class Element>
   void SignatureContext<Element>::Setup(LPSignKey<Element>* sk,
                                         LPVerificationKey<Element>* vk) {
     m_scheme->KeyGen(m_params, sk, vk);
+    // The syndromes of the universe are normally computed with the context,
+    // this only happens if they were dropped since
+    if (m_registry == nullptr)
+      ResetAttributeRegistry();
+  }
+
+  template <class Element>
+  vector<shared_ptr<Matrix<Element>>> SignatureContext<Element>::Extract(const LPSignKey<Element>& sk,
+                                                                      const LPVerificationKey<Element>& vk,
+                                                                      const vector<string>& attributes) {
+    ABS_STATS_PHASE(ABS_PHASE_EXTRACT);
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &signKey = static_cast<const GPVSignKey<Element> &>(sk);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    // Use the precomputed perturbations only if they fit this sign key
+    PerturbationPool<Element> *pool = nullptr;
+    if (m_perturbationPool != nullptr && m_perturbationPool->IsBoundTo(signKey))
+      pool = m_perturbationPool.get();
+
+    return extract(params, signKey, verificationKey, attributes,
+                   m_syndromeCache.get(), m_extractThreads, pool, m_hashMode);
   }
 
   template <class Element>
-  vector<shared_ptr<Matrix<Poly>>> SignatureContext<Element>::Extract(const LPSignKey<Element>& sk,
+  vector<shared_ptr<Matrix<Element>>> SignatureContext<Element>::Extract(const LPSignKey<Element>& sk,
                                                                       const LPVerificationKey<Element>& vk,
-                                                                      vector<string> attributes) {
+                                                                      const vector<AttributeId>& attributes) {
+    ABS_STATS_PHASE(ABS_PHASE_EXTRACT);
 
     auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
     const auto &signKey = static_cast<const GPVSignKey<Element> &>(sk);
     const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
 
-    return extract(params, signKey, verificationKey, attributes);
+    PerturbationPool<Element> *pool = nullptr;
+    if (m_perturbationPool != nullptr && m_perturbationPool->IsBoundTo(signKey))
+      pool = m_perturbationPool.get();
+
+    return extract(params, signKey, verificationKey, Registry(), attributes, m_extractThreads, pool);
+  }
+
+  template <class Element>
+  signatureABS<Element> SignatureContext<Element>::Sign(const LPVerificationKey<Element>& vk,
+                                       const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                       const vector<string>& attributeList,
+                                       const string& message) {
+    MemoryMessageSource source(message);
+    return Sign(vk, attributesKey, attributeList, source);
+  }
+
+  template <class Element>
+  signatureABS<Element> SignatureContext<Element>::Sign(const LPVerificationKey<Element>& vk,
+                                       const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                       const vector<string>& attributeList,
+                                       ABSMessageSource& message) {
+    ABS_STATS_PHASE(ABS_PHASE_SIGN);
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    shared_ptr<const SubsetSumTable<Element>> keyTable = KeyTableFor(attributesKey);
+
+    // Only the online part is left when a nonce was made for this key
+    if (m_signingPool != nullptr && m_signingPool->IsBoundTo(verificationKey, m_tagEncoding)) {
+      shared_ptr<SignatureNonce<Element>> nonce = m_signingPool->Take();
+      return signOnline(params, attributesKey, nonce.get(), message, attributeList, m_hashMode, keyTable.get());
+    }
+
+    return sign(params, attributesKey, verificationKey, message, attributeList, m_tagEncoding, m_hashMode,
+                PreparedKeyFor(verificationKey), keyTable.get());
+  }
+
+  template <class Element>
+  signatureABS<Element> SignatureContext<Element>::Sign(const LPVerificationKey<Element>& vk,
+                                       const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                       const vector<AttributeId>& attributes,
+                                       const string& message) {
+    MemoryMessageSource source(message);
+    return Sign(vk, attributesKey, attributes, source);
+  }
+
+  template <class Element>
+  signatureABS<Element> SignatureContext<Element>::Sign(const LPVerificationKey<Element>& vk,
+                                       const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                       const vector<AttributeId>& attributes,
+                                       ABSMessageSource& message) {
+    ABS_STATS_PHASE(ABS_PHASE_SIGN);
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+    const AttributeRegistry<Element> &registry = Registry();
+
+    shared_ptr<const SubsetSumTable<Element>> keyTable = KeyTableFor(attributesKey);
+
+    if (m_signingPool != nullptr && m_signingPool->IsBoundTo(verificationKey, m_tagEncoding)) {
+      vector<string> attributeList = registry.getNames(attributes);
+      shared_ptr<SignatureNonce<Element>> nonce = m_signingPool->Take();
+
+      signatureABS<Element> signature = signOnline(params, attributesKey, nonce.get(), message, attributeList,
+                                                   registry.getHashMode(), keyTable.get());
+      signature.setAttributeIds(attributes);
+      return signature;
+    }
+
+    return sign(params, attributesKey, verificationKey, message, registry, attributes, m_tagEncoding,
+                PreparedKeyFor(verificationKey), keyTable.get());
+  }
+
+  template <class Element>
+  void SignatureContext<Element>::Sign(const LPVerificationKey<Element>& vk,
+                                       const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                       const vector<string>& attributeList,
+                                       ABSMessageSource& message,
+                                       SignWorkspace<Element>* workspace,
+                                       signatureABS<Element>* signature) {
+    ABS_STATS_PHASE(ABS_PHASE_SIGN);
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    shared_ptr<const SubsetSumTable<Element>> keyTable = KeyTableFor(attributesKey);
+
+    sign(params, attributesKey, verificationKey, message, attributeList, workspace, signature, m_tagEncoding,
+         m_hashMode, PreparedKeyFor(verificationKey), keyTable.get());
   }
 
   template <class Element>
-  signatureABS SignatureContext<Element>::Sign(const LPVerificationKey<Element>& vk,
-                                       vector<shared_ptr<Matrix<Poly>>> attributesKey,
-                                       vector<string> attributeList,
-                                       string message) {
+  vector<signatureABS<Element>> SignatureContext<Element>::SignBatch(const LPVerificationKey<Element>& vk,
+                                                           const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                                           const vector<string>& attributeList,
+                                                           const vector<string>& messages) {
+    ABS_STATS_PHASE(ABS_PHASE_SIGN_BATCH);
 
     auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
     const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
 
-    return sign(params, attributesKey, verificationKey, message, attributeList);
+    shared_ptr<const SubsetSumTable<Element>> keyTable = KeyTableFor(attributesKey);
+
+    return signBatch(params, attributesKey, verificationKey, messages, attributeList, m_tagEncoding, m_batchThreads, m_hashMode,
+                     PreparedKeyFor(verificationKey), keyTable.get());
+  }
+
+  template <class Element>
+  bool SignatureContext<Element>::Verify(const LPVerificationKey<Element>& vk,
+                                         const signatureABS<Element>& signature,
+                                         const string& message) {
+    MemoryMessageSource source(message);
+    return Verify(vk, signature, source);
   }
 
   template <class Element>
   bool SignatureContext<Element>::Verify(const LPVerificationKey<Element>& vk,
-                                         signatureABS signature,
-                                         string message) {
+                                         const signatureABS<Element>& signature,
+                                         ABSMessageSource& message) {
+    ABS_STATS_PHASE(ABS_PHASE_VERIFY);
+    ABSIntraOpScope intraOp(m_intraOpThreads);
 
     auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
     const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
 
-    return verify(params, verificationKey, message, signature);
+    const AttributeRegistry<Element> *registry = RegistryFor(signature);
+    if (registry != nullptr)
+      return verify(params, verificationKey, message, signature, *registry, PreparedKeyFor(verificationKey));
+
+    return verify(params, verificationKey, message, signature, m_syndromeCache.get(),
+                  PreparedKeyFor(verificationKey), m_syndromeTables.get());
+  }
+
+  template <class Element>
+  bool SignatureContext<Element>::Verify(const LPVerificationKey<Element>& vk,
+                                         const signatureABS<Element>& signature,
+                                         ABSMessageSource& message,
+                                         VerifyWorkspace<Element>* workspace) {
+    ABS_STATS_PHASE(ABS_PHASE_VERIFY);
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    const AttributeRegistry<Element> *registry = RegistryFor(signature);
+    if (registry != nullptr)
+      return verify(params, verificationKey, message, signature, *registry, PreparedKeyFor(verificationKey),
+                    workspace);
+
+    return verify(params, verificationKey, message, signature, workspace, m_syndromeCache.get(),
+                  PreparedKeyFor(verificationKey), m_syndromeTables.get());
+  }
+
+  template <class Element>
+  vector<bool> SignatureContext<Element>::VerifyBatch(const LPVerificationKey<Element>& vk,
+                                                     const vector<std::pair<signatureABS<Element>, string>>& batch) {
+    ABS_STATS_PHASE(ABS_PHASE_VERIFY_BATCH);
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    return verifyBatch(params, verificationKey, batch, m_syndromeCache.get(), m_batchThreads,
+                       PreparedKeyFor(verificationKey), m_syndromeTables.get());
+  }
+
+  template <class Element>
+  shared_ptr<SignatureNonce<Element>> SignatureContext<Element>::SignOffline(const LPVerificationKey<Element>& vk) {
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    return signOffline(params, verificationKey, m_tagEncoding, PreparedKeyFor(verificationKey));
+  }
+
+  template <class Element>
+  signatureABS<Element> SignatureContext<Element>::SignOnline(const vector<shared_ptr<Matrix<Element>>>& attributesKey,
+                                                              SignatureNonce<Element>* nonce,
+                                                              const vector<string>& attributeList,
+                                                              ABSMessageSource& message) {
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+
+    shared_ptr<const SubsetSumTable<Element>> keyTable = KeyTableFor(attributesKey);
+
+    return signOnline(params, attributesKey, nonce, message, attributeList, m_hashMode, keyTable.get());
+  }
+
+  template <class Element>
+  Element SignatureContext<Element>::SignatureSyndrome(const signatureABS<Element>& signature) {
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+
+    return signatureSyndrome(params, signature, m_syndromeCache.get(), m_syndromeTables.get());
+  }
+
+  template <class Element>
+  bool SignatureContext<Element>::VerifyWithSyndrome(const LPVerificationKey<Element>& vk,
+                                                     const signatureABS<Element>& signature,
+                                                     const Element& syndrome,
+                                                     ABSMessageSource& message) {
+    ABSIntraOpScope intraOp(m_intraOpThreads);
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    return verifyWithSyndromeSum(params, verificationKey, signature, syndrome, message,
+                                 PreparedKeyFor(verificationKey));
+  }
+
+  template <class Element>
+  bool SignatureContext<Element>::PrepareVerificationKey(const LPVerificationKey<Element>& vk) {
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    const auto &verificationKey = static_cast<const GPVVerificationKey<Element> &>(vk);
+
+    // Keeps the key prepared from a key store for the keys loaded from it
+    if (m_preparedKey != nullptr && m_preparedKey->IsBoundTo(verificationKey))
+      return true;
+
+    m_preparedKey.reset();
+    if (!PreparedVerificationKey<Element>::IsSupported(params->GetILParams()))
+      return false;
+
+    m_preparedKey = std::make_shared<PreparedVerificationKey<Element>>(params, verificationKey);
+    return true;
+  }
+
+  template <class Element>
+  vector<uint8_t> SignatureContext<Element>::SerializeSignature(const signatureABS<Element>& signature) const {
+    return serializeSignature(signature);
+  }
+
+  template <class Element>
+  signatureABS<Element> SignatureContext<Element>::DeserializeSignature(const uint8_t* data, size_t size) const {
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    return deserializeSignature(params, data, size);
+  }
+
+  template <class Element>
+  bool SignatureContext<Element>::EnableSlabAllocator(ABSSlabConfig config) const {
+    if (m_params == nullptr)
+      PALISADE_THROW(config_error, "Generate a GPV context before enabling the slab allocator");
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    shared_ptr<typename Element::Params> ilParams = params->GetILParams();
+
+    config.blockSizes.push_back(coefficientBlockBytes<Element>(ilParams));
+    config.blockSizes.push_back(size_t(ilParams->GetRingDimension()) * sizeof(int64_t));
+    return absSlabEnable(config);
+  }
+
+  template <class Element>
+  void SignatureContext<Element>::SetSyndromeCacheCapacity(size_t capacity) {
+    m_syndromeCacheCapacity = capacity;
+    if (m_syndromeCache != nullptr) {
+      m_syndromeCache->setCapacity(capacity);
+    }
+  }
+
+  template <class Element>
+  void SignatureContext<Element>::SetSubsetSumWindow(usint windowBits, size_t keyTables, size_t syndromeTables) {
+    m_keyTables.reset();
+    m_syndromeTables.reset();
+    if (windowBits == 0)
+      return;
+
+    // Rejects the window widths the tables can not be built with
+    SubsetSumTable<Element>::entriesFor(windowBits);
+    m_keyTables = std::make_shared<SubsetSumTableCache<Element>>(windowBits, keyTables);
+    m_syndromeTables = std::make_shared<SubsetSumTableCache<Element>>(windowBits, syndromeTables);
+  }
+
+  template <class Element>
+  void SignatureContext<Element>::SetAttributeHashMode(AttributeHashMode hashMode) {
+    if (hashMode == m_hashMode)
+      return;
+
+    m_hashMode = hashMode;
+    ResetAttributeRegistry();
+  }
+
+  template <class Element>
+  void SignatureContext<Element>::SetAttributeUniverse(const vector<string>& attributes) {
+    m_attributeNames = attributes;
+    ResetAttributeRegistry();
+  }
+
+  template <class Element>
+  vector<AttributeId> SignatureContext<Element>::AttributeIds(const vector<string>& attributes) const {
+    return Registry().getIds(attributes);
+  }
+
+  template <class Element>
+  void SignatureContext<Element>::ResetAttributeRegistry() {
+    m_registry.reset();
+    if (m_params == nullptr)
+      return;
+
+    auto params = std::static_pointer_cast<GPVSignatureParameters<Element>>(m_params);
+    m_registry = std::make_shared<const AttributeRegistry<Element>>(params, m_attributeNames, m_hashMode,
+                                                                    m_extractThreads);
+  }
+
+  template <class Element>
+  const AttributeRegistry<Element>& SignatureContext<Element>::Registry() const {
+    if (m_registry == nullptr)
+      PALISADE_THROW(config_error, "No attribute registry, generate a GPV context first");
+    return *m_registry;
+  }
+
+  template <class Element>
+  const AttributeRegistry<Element>* SignatureContext<Element>::RegistryFor(
+      const signatureABS<Element>& signature) const {
+    // Opted in subset sum tables add fewer syndromes per signature
+    if (m_registry == nullptr || m_syndromeTables != nullptr ||
+        m_registry->getHashMode() != signature.getHashMode())
+      return nullptr;
+
+    if (m_registry->matches(signature.getAttributeIds(), signature.getAttributeList()))
+      return m_registry.get();
+
+    for (const auto& attribute : signature.getAttributeList()) {
+      AttributeId id;
+      if (!m_registry->find(attribute, &id))
+        return nullptr;
+    }
+    return m_registry.get();
+  }
+
+  template <class Element>
+  void SignatureContext<Element>::ResetSubsetSumTables() {
+    if (m_keyTables != nullptr)
+      m_keyTables->clear();
+    if (m_syndromeTables != nullptr)
+      m_syndromeTables->clear();
+  }
+
+  template <class Element>
+  shared_ptr<const SubsetSumTable<Element>> SignatureContext<Element>::KeyTableFor(
+      const vector<shared_ptr<Matrix<Element>>>& attributesKey) {
+    if (m_keyTables == nullptr || attributesKey.empty())
+      return nullptr;
+
+    // Keys are told apart by the address of their first matrix, and the
+    // table checks the whole key against the matrices it was built from
+    string id = std::to_string(reinterpret_cast<uintptr_t>(attributesKey[0].get()));
+    shared_ptr<const SubsetSumTable<Element>> table = m_keyTables->lookup(id);
+    if (table == nullptr || !table->isBuiltFrom(attributesKey)) {
+      table = std::make_shared<const SubsetSumTable<Element>>(attributesKey, m_keyTables->getWindowBits());
+      m_keyTables->insert(id, table);
+    }
+    return table;
   }
 }  // namespace lbcrypto
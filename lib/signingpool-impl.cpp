@@ -0,0 +1,12 @@
+// @file signingpool-impl.cpp - Forward declarations for SigningPool
+
+#include "signingpool.cpp"
+#include "signingpool.h"
+
+namespace lbcrypto {
+
+template class SigningPool<Poly>;
+template class SigningPool<NativePoly>;
+template class SigningPool<DCRTPoly>;
+
+}  // namespace lbcrypto
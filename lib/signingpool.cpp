@@ -0,0 +1,35 @@
+// @file signingpool.cpp - Implementation of the signature nonce pool
+
+#ifndef _SRC_LIB_SIGNATURE_SIGNINGPOOL_CPP
+#define _SRC_LIB_SIGNATURE_SIGNINGPOOL_CPP
+
+#include "signingpool.h"
+
+namespace lbcrypto {
+
+  template <class Element>
+  SigningPool<Element>::SigningPool(
+    shared_ptr<GPVSignatureParameters<Element>> params,
+    const GPVVerificationKey<Element> &verificationKey, TagEncoding encoding,
+    shared_ptr<const PreparedVerificationKey<Element>> prepared,
+    const PrecomputePoolConfig &config)
+    : m_params(params), m_verificationKey(verificationKey), m_encoding(encoding),
+      m_prepared(prepared), m_pool([this]() { return MakeProducer(); }, config) {}
+
+  template <class Element>
+  typename PrecomputePool<shared_ptr<SignatureNonce<Element>>>::Producer
+  SigningPool<Element>::MakeProducer() {
+    shared_ptr<GPVSignatureParameters<Element>> params = m_params;
+    GPVVerificationKey<Element> verificationKey = m_verificationKey;
+    TagEncoding encoding = m_encoding;
+    shared_ptr<const PreparedVerificationKey<Element>> prepared = m_prepared;
+
+    // signOffline samples with the gaussian generator of the calling thread,
+    // so the workers never share sampler state
+    return [params, verificationKey, encoding, prepared]() {
+      return signOffline(params, verificationKey, encoding, prepared.get());
+    };
+  }
+
+}  // namespace lbcrypto
+#endif
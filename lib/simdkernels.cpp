@@ -0,0 +1,271 @@
+#include "simdkernels.h"
+#include <atomic>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define ABS_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+std::atomic<int> currentLevel(-1);
+
+///////////////////////////////////////////////////////////////////////////////
+//                              Scalar kernels                               //
+///////////////////////////////////////////////////////////////////////////////
+
+void scalarModAdd(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+    for (size_t i = 0; i < n; i++) {
+        uint64_t value = a[i] + b[i];
+        a[i] = value >= q ? value - q : value;
+    }
+}
+
+void scalarModSub(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+    for (size_t i = 0; i < n; i++) {
+        a[i] = a[i] >= b[i] ? a[i] - b[i] : a[i] + q - b[i];
+    }
+}
+
+// Shoup products with 2^32 as the base, valid for q < 2^32. The constant for
+// this base is the top half of the 2^64 one
+void scalarShoupMulAcc32(uint64_t *sum, const uint64_t *x, const uint64_t *a,
+                         const uint64_t *aShoup, size_t n, uint64_t q) {
+    uint64_t twoQ = 2 * q;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t hi = (x[i] * (aShoup[i] >> 32)) >> 32;
+        uint64_t value = sum[i] + (x[i] * a[i] - hi * q);
+        sum[i] = value >= twoQ ? value - twoQ : value;
+    }
+}
+
+void scalarShoupMulAcc64(uint64_t *sum, const uint64_t *x, const uint64_t *a,
+                         const uint64_t *aShoup, size_t n, uint64_t q) {
+    uint64_t twoQ = 2 * q;
+
+    for (size_t i = 0; i < n; i++) {
+        uint64_t hi = static_cast<uint64_t>(((unsigned __int128)x[i] * aShoup[i]) >> 64);
+        uint64_t value = sum[i] + (x[i] * a[i] - hi * q);
+        sum[i] = value >= twoQ ? value - twoQ : value;
+    }
+}
+
+#ifdef ABS_SIMD_X86
+
+///////////////////////////////////////////////////////////////////////////////
+//                               AVX2 kernels                                //
+///////////////////////////////////////////////////////////////////////////////
+
+// The values stay below 2^63, so the signed comparisons of AVX2 are exact
+
+__attribute__((target("avx2")))
+void avx2ModAdd(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+    const __m256i vq = _mm256_set1_epi64x(q);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        __m256i value = _mm256_add_epi64(va, vb);
+        __m256i below = _mm256_cmpgt_epi64(vq, value);
+        value = _mm256_sub_epi64(value, _mm256_andnot_si256(below, vq));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), value);
+    }
+    scalarModAdd(a + i, b + i, n - i, q);
+}
+
+__attribute__((target("avx2")))
+void avx2ModSub(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+    const __m256i vq = _mm256_set1_epi64x(q);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        __m256i borrow = _mm256_cmpgt_epi64(vb, va);
+        __m256i value = _mm256_sub_epi64(va, vb);
+        value = _mm256_add_epi64(value, _mm256_and_si256(borrow, vq));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(a + i), value);
+    }
+    scalarModSub(a + i, b + i, n - i, q);
+}
+
+__attribute__((target("avx2")))
+void avx2ShoupMulAcc32(uint64_t *sum, const uint64_t *x, const uint64_t *a,
+                       const uint64_t *aShoup, size_t n, uint64_t q) {
+    const __m256i vq = _mm256_set1_epi64x(q);
+    const __m256i vTwoQ = _mm256_set1_epi64x(2 * q);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i));
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i vShoup = _mm256_srli_epi64(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(aShoup + i)), 32);
+        __m256i vs = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sum + i));
+
+        __m256i hi = _mm256_srli_epi64(_mm256_mul_epu32(vx, vShoup), 32);
+        __m256i product = _mm256_sub_epi64(_mm256_mul_epu32(vx, va), _mm256_mul_epu32(hi, vq));
+        __m256i value = _mm256_add_epi64(vs, product);
+        __m256i below = _mm256_cmpgt_epi64(vTwoQ, value);
+        value = _mm256_sub_epi64(value, _mm256_andnot_si256(below, vTwoQ));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(sum + i), value);
+    }
+    scalarShoupMulAcc32(sum + i, x + i, a + i, aShoup + i, n - i, q);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//                              AVX-512 kernels                              //
+///////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("avx512f")))
+void avx512ModAdd(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+    const __m512i vq = _mm512_set1_epi64(q);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m512i value = _mm512_add_epi64(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+        __mmask8 reduce = _mm512_cmpge_epu64_mask(value, vq);
+        value = _mm512_mask_sub_epi64(value, reduce, value, vq);
+        _mm512_storeu_si512(a + i, value);
+    }
+    scalarModAdd(a + i, b + i, n - i, q);
+}
+
+__attribute__((target("avx512f")))
+void avx512ModSub(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+    const __m512i vq = _mm512_set1_epi64(q);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m512i va = _mm512_loadu_si512(a + i);
+        __m512i vb = _mm512_loadu_si512(b + i);
+        __mmask8 borrow = _mm512_cmplt_epu64_mask(va, vb);
+        __m512i value = _mm512_sub_epi64(va, vb);
+        value = _mm512_mask_add_epi64(value, borrow, value, vq);
+        _mm512_storeu_si512(a + i, value);
+    }
+    scalarModSub(a + i, b + i, n - i, q);
+}
+
+__attribute__((target("avx512f")))
+void avx512ShoupMulAcc32(uint64_t *sum, const uint64_t *x, const uint64_t *a,
+                         const uint64_t *aShoup, size_t n, uint64_t q) {
+    const __m512i vq = _mm512_set1_epi64(q);
+    const __m512i vTwoQ = _mm512_set1_epi64(2 * q);
+    size_t i = 0;
+
+    // The zero-masked forms with every lane selected are the same shifts and
+    // products. The plain ones pass _mm512_undefined_epi32() as their merge
+    // source, which GCC 12 reports as -Wmaybe-uninitialized once inlined
+    const __mmask8 all = 0xFF;
+
+    for (; i + 8 <= n; i += 8) {
+        __m512i vx = _mm512_loadu_si512(x + i);
+        __m512i vShoup = _mm512_maskz_srli_epi64(all, _mm512_loadu_si512(aShoup + i), 32);
+
+        __m512i hi = _mm512_maskz_srli_epi64(all, _mm512_maskz_mul_epu32(all, vx, vShoup), 32);
+        __m512i product = _mm512_sub_epi64(_mm512_maskz_mul_epu32(all, vx, _mm512_loadu_si512(a + i)),
+                                           _mm512_maskz_mul_epu32(all, hi, vq));
+        __m512i value = _mm512_add_epi64(_mm512_loadu_si512(sum + i), product);
+        __mmask8 reduce = _mm512_cmpge_epu64_mask(value, vTwoQ);
+        value = _mm512_mask_sub_epi64(value, reduce, value, vTwoQ);
+        _mm512_storeu_si512(sum + i, value);
+    }
+    scalarShoupMulAcc32(sum + i, x + i, a + i, aShoup + i, n - i, q);
+}
+
+#endif  // ABS_SIMD_X86
+
+}  // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef ABS_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_AVX2;
+    }
+#endif
+    return SIMD_SCALAR;
+}
+
+SimdLevel getSimdLevel() {
+    int level = currentLevel.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = detectSimdLevel();
+        currentLevel.store(level, std::memory_order_relaxed);
+    }
+    return static_cast<SimdLevel>(level);
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    SimdLevel supported = detectSimdLevel();
+    if (level > supported) {
+        level = supported;
+    }
+    currentLevel.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+const char *simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX512:
+            return "avx512";
+        case SIMD_AVX2:
+            return "avx2";
+        default:
+            return "scalar";
+    }
+}
+
+void vectorModAdd(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+#ifdef ABS_SIMD_X86
+    switch (getSimdLevel()) {
+        case SIMD_AVX512:
+            return avx512ModAdd(a, b, n, q);
+        case SIMD_AVX2:
+            return avx2ModAdd(a, b, n, q);
+        default:
+            break;
+    }
+#endif
+    scalarModAdd(a, b, n, q);
+}
+
+void vectorModSub(uint64_t *a, const uint64_t *b, size_t n, uint64_t q) {
+#ifdef ABS_SIMD_X86
+    switch (getSimdLevel()) {
+        case SIMD_AVX512:
+            return avx512ModSub(a, b, n, q);
+        case SIMD_AVX2:
+            return avx2ModSub(a, b, n, q);
+        default:
+            break;
+    }
+#endif
+    scalarModSub(a, b, n, q);
+}
+
+void vectorShoupMulAcc(uint64_t *sum, const uint64_t *x, const uint64_t *a,
+                       const uint64_t *aShoup, size_t n, uint64_t q) {
+    // Wider moduli need the 128 bit products, which have no vector form
+    if (q >> 32) {
+        return scalarShoupMulAcc64(sum, x, a, aShoup, n, q);
+    }
+
+#ifdef ABS_SIMD_X86
+    switch (getSimdLevel()) {
+        case SIMD_AVX512:
+            return avx512ShoupMulAcc32(sum, x, a, aShoup, n, q);
+        case SIMD_AVX2:
+            return avx2ShoupMulAcc32(sum, x, a, aShoup, n, q);
+        default:
+            break;
+    }
+#endif
+    scalarShoupMulAcc32(sum, x, a, aShoup, n, q);
+}
@@ -0,0 +1,10 @@
+#include "subsetsum.cpp"
+#include "subsetsum.h"
+
+template class SubsetSumTable<Poly>;
+template class SubsetSumTable<NativePoly>;
+template class SubsetSumTable<DCRTPoly>;
+
+template class SubsetSumTableCache<Poly>;
+template class SubsetSumTableCache<NativePoly>;
+template class SubsetSumTableCache<DCRTPoly>;
@@ -0,0 +1,249 @@
+#ifndef _SRC_LIB_SUBSETSUM_CPP
+#define _SRC_LIB_SUBSETSUM_CPP
+
+#include "subsetsum.h"
+#include "abselement.h"
+#include "absparallel.h"
+#include "absstats.h"
+
+// Number of windows covering the 32 bits of a tag
+static usint windowCount(usint windowBits) {
+    return (32 + windowBits - 1) / windowBits;
+}
+
+static void checkWindowBits(usint windowBits) {
+    if (windowBits == 0 || windowBits > SUBSET_SUM_MAX_WINDOW_BITS) {
+        PALISADE_THROW(config_error, "Subset sum windows must have between 1 and " +
+                       std::to_string(SUBSET_SUM_MAX_WINDOW_BITS) + " bits");
+    }
+}
+
+template <class Element>
+size_t SubsetSumTable<Element>::entriesFor(usint windowBits) {
+    checkWindowBits(windowBits);
+
+    // Every window but a shorter last one has 2^windowBits - 1 subsets
+    usint lastBits = 32 - (windowCount(windowBits) - 1) * windowBits;
+    return (windowCount(windowBits) - 1) * ((size_t(1) << windowBits) - 1) + ((size_t(1) << lastBits) - 1);
+}
+
+template <class Element>
+SubsetSumTable<Element>::SubsetSumTable(const vector<shared_ptr<Matrix<Element>>> &attributesKey, usint windowBits)
+    : windowBits(windowBits) {
+
+    if (attributesKey.size() != 32) {
+        PALISADE_THROW(config_error, "An attribute key has 32 matrices");
+    }
+
+    this->rows = attributesKey[0]->GetRows();
+    this->cols = attributesKey[0]->GetCols();
+
+    vector<vector<Element>> values(32);
+    for (int i = 0; i < 32; i++) {
+        const Matrix<Element> &key = *attributesKey[i];
+        if (key.GetRows() != this->rows || key.GetCols() != this->cols) {
+            PALISADE_THROW(config_error, "Attribute key matrices of different sizes");
+        }
+
+        values[i].reserve(this->rows * this->cols);
+        for (size_t r = 0; r < this->rows; r++) {
+            for (size_t c = 0; c < this->cols; c++) {
+                values[i].push_back(key(r, c));
+            }
+        }
+        this->sources.push_back(attributesKey[i]);
+    }
+
+    build(values);
+}
+
+template <class Element>
+SubsetSumTable<Element>::SubsetSumTable(const Matrix<Element> &syndromeMatrix, usint windowBits)
+    : windowBits(windowBits), rows(1), cols(1) {
+
+    if (syndromeMatrix.GetRows() != 1 || syndromeMatrix.GetCols() != 32) {
+        PALISADE_THROW(config_error, "A syndrome matrix has 1 row and 32 columns");
+    }
+
+    vector<vector<Element>> values(32);
+    for (int i = 0; i < 32; i++) {
+        values[i].push_back(syndromeMatrix(0, i));
+    }
+
+    build(values);
+}
+
+template <class Element>
+void SubsetSumTable<Element>::build(const vector<vector<Element>> &values) {
+    checkWindowBits(this->windowBits);
+
+    ABS_STATS_PHASE(ABS_PHASE_SUBSET_SUM_BUILD);
+
+    this->width = values[0].size();
+    this->entries.reserve(entriesFor(this->windowBits) * this->width);
+
+    for (usint window = 0; window < windowCount(this->windowBits); window++) {
+        usint first = window * this->windowBits;
+        usint bits = std::min(this->windowBits, 32 - first);
+
+        // Subsets are built in increasing order, so the subset without its
+        // lowest bit is always ready. Bit b of a subset selects the value
+        // first + bits - 1 - b, as the tag is read from its most significant bit
+        for (uint32_t subset = 1; subset < (uint32_t(1) << bits); subset++) {
+            uint32_t rest = subset & (subset - 1);
+            usint lowest = __builtin_ctz(subset);
+            const vector<Element> &value = values[first + bits - 1 - lowest];
+
+            for (size_t e = 0; e < this->width; e++) {
+                if (rest == 0) {
+                    this->entries.push_back(value[e]);
+                } else {
+                    this->entries.push_back(this->entries[entryOffset(window, rest) + e]);
+                    addInPlace(&this->entries.back(), value[e]);
+                }
+            }
+        }
+    }
+}
+
+template <class Element>
+size_t SubsetSumTable<Element>::entryOffset(usint window, uint32_t subset) const {
+    return (window * ((size_t(1) << this->windowBits) - 1) + subset - 1) * this->width;
+}
+
+template <class Element>
+void SubsetSumTable<Element>::accumulate(uint32_t h, Matrix<Element> *sum) const {
+    if (sum->GetRows() != this->rows || sum->GetCols() != this->cols) {
+        PALISADE_THROW(math_error, "Matrix size does not match the subset sum table");
+    }
+
+    // Entries selected by the windows of the tag
+    vector<const Element *> selected;
+    for (usint window = 0; window < windowCount(this->windowBits); window++) {
+        usint first = window * this->windowBits;
+        usint bits = std::min(this->windowBits, 32 - first);
+        uint32_t subset = (h >> (32 - first - bits)) & ((uint32_t(1) << bits) - 1);
+
+        if (subset != 0) {
+            selected.push_back(&this->entries[entryOffset(window, subset)]);
+        }
+    }
+
+    // The cells of the sum are independent, so they are split among the
+    // intra-operation workers
+    usint threads = absIntraOpThreads();
+    int cells = static_cast<int>(this->width);
+
+#pragma omp parallel for schedule(static) num_threads(threads) if(threads > 1)
+    for (int cell = 0; cell < cells; cell++) {
+        Element &target = (*sum)(cell / this->cols, cell % this->cols);
+        for (const Element *entry : selected) {
+            addInPlace(&target, entry[cell]);
+        }
+    }
+}
+
+template <class Element>
+void SubsetSumTable<Element>::accumulate(uint32_t h, Element *sum) const {
+    if (this->width != 1) {
+        PALISADE_THROW(math_error, "The subset sum table does not hold single ring elements");
+    }
+
+    for (usint window = 0; window < windowCount(this->windowBits); window++) {
+        usint first = window * this->windowBits;
+        usint bits = std::min(this->windowBits, 32 - first);
+        uint32_t subset = (h >> (32 - first - bits)) & ((uint32_t(1) << bits) - 1);
+
+        if (subset != 0) {
+            addInPlace(sum, this->entries[entryOffset(window, subset)]);
+        }
+    }
+}
+
+template <class Element>
+bool SubsetSumTable<Element>::isBuiltFrom(const vector<shared_ptr<Matrix<Element>>> &attributesKey) const {
+    if (this->sources.size() != attributesKey.size()) {
+        return false;
+    }
+
+    // A matrix freed and reallocated at the same address has expired here
+    for (size_t i = 0; i < attributesKey.size(); i++) {
+        if (this->sources[i].lock() != attributesKey[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <class Element>
+shared_ptr<const SubsetSumTable<Element>> SubsetSumTableCache<Element>::lookup(const string &key) {
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    auto it = this->index.find(key);
+    if (it == this->index.end()) {
+        return nullptr;
+    }
+
+    // Move the entry to the front so it is the last one to be evicted
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+
+    return it->second->second;
+}
+
+template <class Element>
+void SubsetSumTableCache<Element>::insert(const string &key, shared_ptr<const SubsetSumTable<Element>> table) {
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    if (this->capacity == 0) {
+        return;
+    }
+
+    // Another thread may have built the same table concurrently
+    auto it = this->index.find(key);
+    if (it != this->index.end()) {
+        it->second->second = table;
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        return;
+    }
+
+    this->entries.emplace_front(key, table);
+    this->index[key] = this->entries.begin();
+    shrink();
+}
+
+template <class Element>
+void SubsetSumTableCache<Element>::clear() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->index.clear();
+    this->entries.clear();
+}
+
+template <class Element>
+size_t SubsetSumTableCache<Element>::getCapacity() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->capacity;
+}
+
+template <class Element>
+void SubsetSumTableCache<Element>::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->capacity = capacity;
+    shrink();
+}
+
+template <class Element>
+size_t SubsetSumTableCache<Element>::getSize() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->entries.size();
+}
+
+template <class Element>
+void SubsetSumTableCache<Element>::shrink() {
+    while (this->entries.size() > this->capacity) {
+        this->index.erase(this->entries.back().first);
+        this->entries.pop_back();
+    }
+}
+
+#endif
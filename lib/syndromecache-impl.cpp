@@ -0,0 +1,6 @@
+#include "syndromecache.cpp"
+#include "syndromecache.h"
+
+template class AttributeSyndromeCache<Poly>;
+template class AttributeSyndromeCache<NativePoly>;
+template class AttributeSyndromeCache<DCRTPoly>;
@@ -0,0 +1,86 @@
+#ifndef _SRC_LIB_SYNDROMECACHE_CPP
+#define _SRC_LIB_SYNDROMECACHE_CPP
+
+#include "syndromecache.h"
+
+template <class Element>
+shared_ptr<const typename AttributeSyndromeCache<Element>::SyndromeRow> AttributeSyndromeCache<Element>::lookup(const string &attribute) {
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    auto it = this->index.find(attribute);
+    if (it == this->index.end()) {
+        this->misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    // Move the entry to the front so it is the last one to be evicted
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    this->hits.fetch_add(1, std::memory_order_relaxed);
+
+    return it->second->second;
+}
+
+template <class Element>
+void AttributeSyndromeCache<Element>::insert(const string &attribute, shared_ptr<const SyndromeRow> row) {
+    std::lock_guard<std::mutex> guard(this->lock);
+
+    if (this->capacity == 0) {
+        return;
+    }
+
+    // Another thread may have computed the same attribute concurrently
+    auto it = this->index.find(attribute);
+    if (it != this->index.end()) {
+        it->second->second = row;
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        return;
+    }
+
+    this->entries.emplace_front(attribute, row);
+    this->index[attribute] = this->entries.begin();
+    shrink();
+}
+
+template <class Element>
+void AttributeSyndromeCache<Element>::clear() {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->index.clear();
+    this->entries.clear();
+}
+
+template <class Element>
+size_t AttributeSyndromeCache<Element>::getCapacity() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->capacity;
+}
+
+template <class Element>
+void AttributeSyndromeCache<Element>::setCapacity(size_t capacity) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->capacity = capacity;
+    shrink();
+}
+
+template <class Element>
+size_t AttributeSyndromeCache<Element>::getSize() const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->entries.size();
+}
+
+template <class Element>
+void AttributeSyndromeCache<Element>::resetCounters() {
+    this->hits.store(0, std::memory_order_relaxed);
+    this->misses.store(0, std::memory_order_relaxed);
+    this->evictions.store(0, std::memory_order_relaxed);
+}
+
+template <class Element>
+void AttributeSyndromeCache<Element>::shrink() {
+    while (this->entries.size() > this->capacity) {
+        this->index.erase(this->entries.back().first);
+        this->entries.pop_back();
+        this->evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+#endif
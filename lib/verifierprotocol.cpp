@@ -0,0 +1,181 @@
+#include "verifierprotocol.h"
+#include "utils/exception.h"
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Bytes read from a socket at a time
+static const size_t READ_SIZE = 64 * 1024;
+
+static void appendU32(uint32_t value, std::vector<uint8_t> *out) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out->push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+static void appendU64(uint64_t value, std::vector<uint8_t> *out) {
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out->push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+static uint32_t readU32(const uint8_t *data) {
+    return (uint32_t(data[0]) << 24) | (uint32_t(data[1]) << 16) | (uint32_t(data[2]) << 8) | uint32_t(data[3]);
+}
+
+static uint64_t readU64(const uint8_t *data) {
+    return (uint64_t(readU32(data)) << 32) | readU32(data + 4);
+}
+
+// Frame header and common payload prefix, the payload size is filled in by
+// finishFrame once the payload is complete
+static size_t beginFrame(VerifierMessageType type, uint64_t id, std::vector<uint8_t> *out) {
+    size_t frame = out->size();
+    appendU32(0, out);
+    out->push_back(static_cast<uint8_t>(type));
+    appendU64(id, out);
+    return frame;
+}
+
+static void finishFrame(size_t frame, std::vector<uint8_t> *out) {
+    uint32_t size = static_cast<uint32_t>(out->size() - frame - 4);
+    for (int i = 0; i < 4; i++) {
+        (*out)[frame + i] = static_cast<uint8_t>(size >> (24 - 8 * i));
+    }
+}
+
+void appendVerifyRequest(uint64_t id, const std::vector<uint8_t> &signature, const std::string &message,
+                         std::vector<uint8_t> *out) {
+    size_t frame = beginFrame(VERIFIER_VERIFY, id, out);
+    appendU32(static_cast<uint32_t>(signature.size()), out);
+    out->insert(out->end(), signature.begin(), signature.end());
+    out->insert(out->end(), message.begin(), message.end());
+    finishFrame(frame, out);
+}
+
+void appendStatsRequest(uint64_t id, std::vector<uint8_t> *out) {
+    size_t frame = beginFrame(VERIFIER_STATS, id, out);
+    finishFrame(frame, out);
+}
+
+void appendVerifyResponse(uint64_t id, VerifierStatus status, std::vector<uint8_t> *out) {
+    size_t frame = beginFrame(VERIFIER_VERIFY, id, out);
+    out->push_back(static_cast<uint8_t>(status));
+    finishFrame(frame, out);
+}
+
+void appendStatsResponse(uint64_t id, const std::string &stats, std::vector<uint8_t> *out) {
+    size_t frame = beginFrame(VERIFIER_STATS, id, out);
+    out->insert(out->end(), stats.begin(), stats.end());
+    finishFrame(frame, out);
+}
+
+// Type and id shared by every payload
+static void parseHeader(const uint8_t *payload, size_t size, VerifierMessageType *type, uint64_t *id) {
+    if (size < 9) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Truncated verifier frame");
+    }
+    if (payload[0] != VERIFIER_VERIFY && payload[0] != VERIFIER_STATS) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Unknown verifier message type");
+    }
+
+    *type = static_cast<VerifierMessageType>(payload[0]);
+    *id = readU64(payload + 1);
+}
+
+void parseVerifierRequest(const uint8_t *payload, size_t size, VerifierRequest *request) {
+    parseHeader(payload, size, &request->type, &request->id);
+    request->signature = request->message = nullptr;
+    request->signatureSize = request->messageSize = 0;
+
+    if (request->type == VERIFIER_STATS) {
+        return;
+    }
+
+    if (size < 13 || readU32(payload + 9) > size - 13) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Truncated verify request");
+    }
+
+    request->signatureSize = readU32(payload + 9);
+    request->signature = payload + 13;
+    request->message = request->signature + request->signatureSize;
+    request->messageSize = size - 13 - request->signatureSize;
+}
+
+void parseVerifierResponse(const uint8_t *payload, size_t size, VerifierResponse *response) {
+    parseHeader(payload, size, &response->type, &response->id);
+    response->status = VERIFIER_VALID;
+    response->stats.clear();
+
+    if (response->type == VERIFIER_STATS) {
+        response->stats.assign(reinterpret_cast<const char *>(payload + 9), size - 9);
+        return;
+    }
+
+    if (size != 10 || payload[9] > VERIFIER_OVERLOADED) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Malformed verify response");
+    }
+    response->status = static_cast<VerifierStatus>(payload[9]);
+}
+
+bool VerifierFrameReader::fill() {
+    // Drop the frames already handed out before reading more
+    if (this->start > 0) {
+        this->buffer.erase(this->buffer.begin(), this->buffer.begin() + this->start);
+        this->start = 0;
+    }
+
+    size_t used = this->buffer.size();
+    this->buffer.resize(used + READ_SIZE);
+
+    ssize_t got;
+    do {
+        got = read(this->fd, this->buffer.data() + used, READ_SIZE);
+    } while (got < 0 && errno == EINTR);
+
+    if (got < 0) {
+        this->buffer.resize(used);
+        PALISADE_THROW(lbcrypto::deserialize_error, "Cannot read the verifier connection");
+    }
+
+    this->buffer.resize(used + got);
+    return got > 0;
+}
+
+bool VerifierFrameReader::next(const uint8_t **payload, size_t *size) {
+    size_t available = this->buffer.size() - this->start;
+    if (available < 4) {
+        return false;
+    }
+
+    size_t length = readU32(this->buffer.data() + this->start);
+    if (length > VERIFIER_MAX_FRAME) {
+        PALISADE_THROW(lbcrypto::deserialize_error, "Verifier frame too large");
+    }
+    if (available < 4 + length) {
+        return false;
+    }
+
+    *payload = this->buffer.data() + this->start + 4;
+    *size = length;
+    this->start += 4 + length;
+
+    return true;
+}
+
+bool writeVerifierFrames(int fd, const std::vector<uint8_t> &frames) {
+    size_t written = 0;
+
+    while (written < frames.size()) {
+        ssize_t sent = send(fd, frames.data() + written, frames.size() - written, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        written += sent;
+    }
+
+    return true;
+}
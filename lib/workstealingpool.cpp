@@ -0,0 +1,148 @@
+// @file workstealingpool.cpp - Bounded work stealing thread pool
+
+#include "workstealingpool.h"
+#include "utils/parallel.h"
+
+namespace lbcrypto {
+
+// Pool and queue of the worker running on this thread, if any
+static thread_local const WorkStealingPool* currentPool = nullptr;
+static thread_local usint currentWorker = 0;
+
+WorkStealingPool::WorkStealingPool(const WorkStealingPoolConfig& config)
+    : m_capacity(config.capacity), m_stop(false), m_queued(0), m_nextQueue(0) {
+  usint workers = config.workers;
+  if (workers == 0) workers = PalisadeParallelControls.GetMachineThreads();
+  if (workers == 0) workers = 1;
+  if (m_capacity == 0) m_capacity = 1;
+
+  for (usint i = 0; i < workers; i++)
+    m_queues.emplace_back(new WorkerQueue());
+  for (usint i = 0; i < workers; i++)
+    m_workers.emplace_back(&WorkStealingPool::Run, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_stop = true;
+  }
+  m_wakeup.notify_all();
+  for (auto& worker : m_workers) worker.join();
+}
+
+void WorkStealingPool::Submit(Task task) {
+  {
+    std::unique_lock<std::mutex> lock(m_lock);
+    if (m_stats.pending >= m_capacity) {
+      m_stats.waits++;
+      m_room.wait(lock, [this] { return m_stats.pending < m_capacity; });
+    }
+    m_stats.pending++;
+    m_stats.submitted++;
+    if (m_stats.pending > m_stats.maxPending) m_stats.maxPending = m_stats.pending;
+  }
+  Push(std::move(task));
+}
+
+bool WorkStealingPool::TrySubmit(Task task) {
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_stats.pending >= m_capacity) {
+      m_stats.rejected++;
+      return false;
+    }
+    m_stats.pending++;
+    m_stats.submitted++;
+    if (m_stats.pending > m_stats.maxPending) m_stats.maxPending = m_stats.pending;
+  }
+  Push(std::move(task));
+  return true;
+}
+
+WorkStealingPoolStats WorkStealingPool::GetStats() const {
+  std::lock_guard<std::mutex> guard(m_lock);
+  return m_stats;
+}
+
+void WorkStealingPool::Push(Task task) {
+  // A task queued by a task stays with its worker, which keeps related work
+  // on the same core unless another worker runs out of tasks
+  size_t index = currentPool == this
+                     ? currentWorker
+                     : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+  WorkerQueue& queue = *m_queues[index];
+  {
+    std::lock_guard<std::mutex> guard(queue.lock);
+    queue.tasks.push_back(std::move(task));
+  }
+
+  {
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_queued++;
+  }
+  m_wakeup.notify_one();
+}
+
+bool WorkStealingPool::Pop(usint worker, Task* task) {
+  {
+    WorkerQueue& own = *m_queues[worker];
+    std::lock_guard<std::mutex> guard(own.lock);
+    if (!own.tasks.empty()) {
+      *task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // Steal the oldest task of the next busy queue
+  for (size_t i = 1; i < m_queues.size(); i++) {
+    WorkerQueue& victim = *m_queues[(worker + i) % m_queues.size()];
+    std::lock_guard<std::mutex> guard(victim.lock);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      std::lock_guard<std::mutex> statsGuard(m_lock);
+      m_stats.stolen++;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void WorkStealingPool::Run(usint worker) {
+  currentPool = this;
+  currentWorker = worker;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_lock);
+      m_wakeup.wait(lock, [this] { return m_stop || m_queued > 0; });
+      // Tasks still queued are run before stopping
+      if (m_stop && m_queued == 0) return;
+    }
+
+    Task task;
+    if (!Pop(worker, &task)) {
+      // Another worker took the task this one was woken up for
+      std::this_thread::yield();
+      continue;
+    }
+
+    {
+      std::lock_guard<std::mutex> guard(m_lock);
+      m_queued--;
+      m_stats.pending--;
+    }
+    m_room.notify_one();
+
+    task();
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_stats.executed++;
+  }
+}
+
+}  // namespace lbcrypto
@@ -0,0 +1,453 @@
+// Batch signing and verification of record files. The records stream through
+// a pipeline of four threads joined by bounded single producer, single
+// consumer queues, so reading, hashing, lattice arithmetic and writing of
+// different records overlap while memory stays bounded by the queues.
+//
+// Usage: abs-batch sign --keystore file --input in --output out [--lines]
+//                  [--attributes a,b,...] [--queue 64] [--slab] [--huge-pages]
+//        abs-batch verify --keystore file --input in --output out [--queue 64]
+//                  [--slab] [--huge-pages]
+//
+// sign reads messages, each one a 4 byte big-endian length followed by its
+// bytes, or one per line with --lines. It extracts a key for --attributes
+// (every attribute of abs.h by default) and writes one record per message:
+//
+//   signature length (4 bytes) | signature | message length (4 bytes) | message
+//
+// with the signature in the compact wire format of abswire.h and the lengths
+// big-endian. verify reads such records and writes one line per record,
+// "index valid", "index invalid" or "index malformed", in input order. The
+// stages are
+//
+//   sign:   read | offline (y and A*y) | online (tag and key sum) | write
+//   verify: read and decode | syndromes | lattice and tag | write
+//
+// "-" stands for the standard input or output. At the end the throughput and,
+// per stage, the share of the time it was busy, the mean occupancy of its
+// input queue and the share of the time it waited for input or for room in
+// its output queue go to stderr. verify exits with status 1 if any record is
+// not valid. --slab serves the ring elements from the slab allocator, backed
+// by huge pages with --huge-pages, as the stages free the elements the
+// previous ones allocated.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "keystore.h"
+#include "messagesource.h"
+#include "spscqueue.h"
+
+using namespace lbcrypto;
+
+typedef std::chrono::steady_clock Clock;
+
+// Largest signature or message accepted in a record
+static const uint32_t MAX_RECORD_FIELD = 16 * 1024 * 1024;
+
+struct BatchOptions {
+  string mode;
+  string keystore;
+  string input;
+  string output;
+  bool lines = false;
+  bool slab = false;
+  bool hugePages = false;
+  vector<string> attributes;
+  size_t queue = 64;
+};
+
+// Work done by one stage thread
+struct StageStats {
+  explicit StageStats(const char *name) : name(name) {}
+
+  const char *name;
+  uint64_t items = 0;
+  uint64_t busyNs = 0;
+};
+
+template <class Item>
+using RecordQueue = SpscQueue<unique_ptr<Item>>;
+
+static uint64_t elapsedNs(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// Reads a 4 byte big-endian length and that many bytes. Returns false at the
+// end of the input, throws deserialize_error on a truncated field
+static bool readField(std::istream &in, string *field, bool first) {
+  unsigned char length[4];
+  in.read(reinterpret_cast<char *>(length), 4);
+  if (in.gcount() == 0 && first) return false;
+  if (in.gcount() != 4) PALISADE_THROW(deserialize_error, "Truncated record length");
+
+  uint32_t size = (uint32_t(length[0]) << 24) | (uint32_t(length[1]) << 16) | (uint32_t(length[2]) << 8) |
+                  uint32_t(length[3]);
+  if (size > MAX_RECORD_FIELD) PALISADE_THROW(deserialize_error, "Record field too large");
+
+  field->resize(size);
+  in.read(&(*field)[0], size);
+  if (static_cast<uint32_t>(in.gcount()) != size) PALISADE_THROW(deserialize_error, "Truncated record");
+  return true;
+}
+
+static void writeField(std::ostream &out, const void *data, size_t size) {
+  uint32_t length = static_cast<uint32_t>(size);
+  char header[4] = {static_cast<char>(length >> 24), static_cast<char>(length >> 16),
+                    static_cast<char>(length >> 8), static_cast<char>(length)};
+  out.write(header, 4);
+  out.write(static_cast<const char *>(data), size);
+}
+
+// Opens a file, or the standard stream for "-"
+class Streams {
+ public:
+  bool open(const BatchOptions &options) {
+    if (options.input != "-") {
+      inFile.open(options.input, std::ios::binary);
+      if (!inFile) return false;
+    }
+    if (options.output != "-") {
+      outFile.open(options.output, std::ios::binary | std::ios::trunc);
+      if (!outFile) return false;
+    }
+    return true;
+  }
+
+  std::istream &in() { return inFile.is_open() ? static_cast<std::istream &>(inFile) : std::cin; }
+  std::ostream &out() { return outFile.is_open() ? static_cast<std::ostream &>(outFile) : std::cout; }
+
+ private:
+  std::ifstream inFile;
+  std::ofstream outFile;
+};
+
+// Pipeline of four stages: a source producing the records, two stages
+// transforming them in place and a sink consuming them. An exception fails
+// the run: the source stops, a middle stage drops the record and the sink
+// skips it
+template <class Item>
+class Pipeline {
+ public:
+  typedef std::function<unique_ptr<Item>()> Source;
+  typedef std::function<void(Item *)> Stage;
+
+  Pipeline(size_t capacity, const char *names[4])
+      : first(capacity), second(capacity), third(capacity),
+        stats{StageStats(names[0]), StageStats(names[1]), StageStats(names[2]), StageStats(names[3])} {}
+
+  // Runs the stages until the source returns nullptr, returning false if any
+  // of them failed
+  bool run(Source source, Stage one, Stage two, Stage sink) {
+    auto start = Clock::now();
+
+    std::thread reader([&] {
+      try {
+        for (;;) {
+          auto begin = Clock::now();
+          unique_ptr<Item> item = source();
+          stats[0].busyNs += elapsedNs(begin);
+          if (item == nullptr) break;
+          stats[0].items++;
+          first.Push(std::move(item));
+        }
+      } catch (const std::exception &e) {
+        fail(e.what());
+      }
+      first.Close();
+    });
+    std::thread middle([&] { transform(&first, &second, &stats[1], one); });
+    std::thread last([&] { transform(&second, &third, &stats[2], two); });
+
+    unique_ptr<Item> item;
+    while (third.Pop(&item)) {
+      auto begin = Clock::now();
+      try {
+        sink(item.get());
+      } catch (const std::exception &e) {
+        fail(e.what());
+      }
+      stats[3].busyNs += elapsedNs(begin);
+      stats[3].items++;
+    }
+
+    reader.join();
+    middle.join();
+    last.join();
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return error.empty();
+  }
+
+  // Throughput and per stage utilization, in the format described above
+  void report(std::ostream &out) const {
+    const SpscQueueStats *inputs[4] = {nullptr, &first.GetStats(), &second.GetStats(), &third.GetStats()};
+    const SpscQueueStats *outputs[4] = {&first.GetStats(), &second.GetStats(), &third.GetStats(), nullptr};
+    double ns = seconds * 1e9;
+
+    out << std::fixed << std::setprecision(1) << "records " << stats[3].items << " in " << seconds << " s, "
+        << (seconds > 0 ? stats[3].items / seconds : 0) << " records/s" << std::endl;
+    for (int s = 0; s < 4; s++) {
+      out << std::left << std::setw(10) << stats[s].name << std::right << " busy " << std::setw(5)
+          << 100 * stats[s].busyNs / ns << "%";
+      if (inputs[s] != nullptr) {
+        const SpscQueueStats &input = *inputs[s];
+        out << "  queue " << std::setw(5)
+            << (input.pushed > 0 ? static_cast<double>(input.occupancySum) / input.pushed : 0) << "  starved "
+            << std::setw(5) << 100 * input.starvedNs / ns << "%";
+      }
+      if (outputs[s] != nullptr) {
+        out << "  blocked " << std::setw(5) << 100 * outputs[s]->blockedNs / ns << "%";
+      }
+      out << std::endl;
+    }
+    if (!error.empty()) out << "error: " << error << std::endl;
+  }
+
+ private:
+  void transform(RecordQueue<Item> *in, RecordQueue<Item> *out, StageStats *stage, const Stage &work) {
+    unique_ptr<Item> item;
+    while (in->Pop(&item)) {
+      auto begin = Clock::now();
+      try {
+        work(item.get());
+      } catch (const std::exception &e) {
+        fail(e.what());
+        item.reset();
+      }
+      stage->busyNs += elapsedNs(begin);
+      stage->items++;
+      if (item != nullptr) out->Push(std::move(item));
+    }
+    out->Close();
+  }
+
+  void fail(const string &what) {
+    std::lock_guard<std::mutex> guard(errorLock);
+    if (error.empty()) error = what;
+  }
+
+  RecordQueue<Item> first;
+  RecordQueue<Item> second;
+  RecordQueue<Item> third;
+  StageStats stats[4];
+  double seconds = 0;
+  std::mutex errorLock;
+  string error;
+};
+
+// Serves the ring elements from slabs when asked, before any is allocated
+template <class Element>
+static void enableSlab(const BatchOptions &options, const SignatureContext<Element> &context) {
+  if (!options.slab) return;
+
+  ABSSlabConfig config;
+  config.hugePages = options.hugePages;
+  if (!context.EnableSlabAllocator(config)) {
+    std::cerr << "Slab allocator not available, using malloc" << std::endl;
+  }
+}
+
+template <class Element>
+struct SignRecord {
+  string message;
+  shared_ptr<SignatureNonce<Element>> nonce;
+  vector<uint8_t> signature;
+};
+
+template <class Element>
+static int runSign(const BatchOptions &options, const KeyStore<Element> &store, Streams *streams) {
+  SignatureContext<Element> context;
+  context.GenerateGPVContext(store);
+  enableSlab(options, context);
+
+  GPVVerificationKey<Element> vk;
+  GPVSignKey<Element> sk;
+  store.LoadVerificationKey(&vk);
+  store.LoadSignKey(&sk);
+  auto ak = context.Extract(sk, vk, options.attributes);
+
+  const char *names[4] = {"read", "offline", "online", "write"};
+  Pipeline<SignRecord<Element>> pipeline(options.queue, names);
+  std::istream &in = streams->in();
+  std::ostream &out = streams->out();
+
+  bool ok = pipeline.run(
+      [&]() -> unique_ptr<SignRecord<Element>> {
+        unique_ptr<SignRecord<Element>> record(new SignRecord<Element>());
+        if (options.lines ? !std::getline(in, record->message) : !readField(in, &record->message, true))
+          return nullptr;
+        return record;
+      },
+      [&](SignRecord<Element> *record) { record->nonce = context.SignOffline(vk); },
+      [&](SignRecord<Element> *record) {
+        MemoryMessageSource source(record->message);
+        auto signature = context.SignOnline(ak, record->nonce.get(), options.attributes, source);
+        record->nonce.reset();
+        record->signature = context.SerializeSignature(signature);
+      },
+      [&](SignRecord<Element> *record) {
+        writeField(out, record->signature.data(), record->signature.size());
+        writeField(out, record->message.data(), record->message.size());
+        if (!out) PALISADE_THROW(serialize_error, "Cannot write the output");
+      });
+
+  out.flush();
+  pipeline.report(std::cerr);
+  return ok && out ? 0 : 1;
+}
+
+template <class Element>
+struct VerifyRecord {
+  uint64_t index = 0;
+  string message;
+  unique_ptr<signatureABS<Element>> signature;
+  Element syndrome;
+  bool valid = false;
+};
+
+template <class Element>
+static int runVerify(const BatchOptions &options, const KeyStore<Element> &store, Streams *streams) {
+  SignatureContext<Element> context;
+  context.GenerateGPVContext(store);
+  enableSlab(options, context);
+
+  GPVVerificationKey<Element> vk;
+  store.LoadVerificationKey(&vk);
+
+  const char *names[4] = {"decode", "syndrome", "lattice", "write"};
+  Pipeline<VerifyRecord<Element>> pipeline(options.queue, names);
+  std::istream &in = streams->in();
+  std::ostream &out = streams->out();
+  uint64_t next = 0;
+  uint64_t notValid = 0;
+
+  bool ok = pipeline.run(
+      [&]() -> unique_ptr<VerifyRecord<Element>> {
+        string signature;
+        if (!readField(in, &signature, true)) return nullptr;
+
+        unique_ptr<VerifyRecord<Element>> record(new VerifyRecord<Element>());
+        record->index = next++;
+        readField(in, &record->message, false);
+        try {
+          record->signature.reset(new signatureABS<Element>(context.DeserializeSignature(
+              reinterpret_cast<const uint8_t *>(signature.data()), signature.size())));
+        } catch (const std::exception &) {
+          // Reported as malformed, the next records are still verified
+        }
+        return record;
+      },
+      [&](VerifyRecord<Element> *record) {
+        if (record->signature == nullptr) return;
+        try {
+          record->syndrome = context.SignatureSyndrome(*record->signature);
+        } catch (const std::exception &) {
+          record->signature.reset();
+        }
+      },
+      [&](VerifyRecord<Element> *record) {
+        if (record->signature == nullptr) return;
+        MemoryMessageSource source(record->message);
+        try {
+          record->valid = context.VerifyWithSyndrome(vk, *record->signature, record->syndrome, source);
+        } catch (const std::exception &) {
+          record->signature.reset();
+        }
+      },
+      [&](VerifyRecord<Element> *record) {
+        const char *status = record->signature == nullptr ? "malformed" : record->valid ? "valid" : "invalid";
+        if (!record->valid) notValid++;
+        out << record->index << ' ' << status << '\n';
+      });
+
+  out.flush();
+  pipeline.report(std::cerr);
+  return ok && out && notValid == 0 ? 0 : 1;
+}
+
+template <class Element>
+static int run(const BatchOptions &options, Streams *streams) {
+  KeyStore<Element> store(options.keystore);
+  if (options.mode == "sign") return runSign(options, store, streams);
+  return runVerify(options, store, streams);
+}
+
+int main(int argc, char *argv[]) {
+  BatchOptions options;
+
+  if (argc > 1) options.mode = argv[1];
+  for (int i = 2; i < argc; i++) {
+    string option = argv[i];
+    if (option == "--lines") {
+      options.lines = true;
+      continue;
+    }
+    if (option == "--slab" || option == "--huge-pages") {
+      options.slab = true;
+      options.hugePages = options.hugePages || option == "--huge-pages";
+      continue;
+    }
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << option << std::endl;
+      return 2;
+    }
+
+    string value = argv[++i];
+    if (option == "--keystore") {
+      options.keystore = value;
+    } else if (option == "--input") {
+      options.input = value;
+    } else if (option == "--output") {
+      options.output = value;
+    } else if (option == "--attributes") {
+      std::istringstream list(value);
+      string attribute;
+      while (std::getline(list, attribute, ',')) {
+        if (!attribute.empty()) options.attributes.push_back(attribute);
+      }
+    } else if (option == "--queue") {
+      options.queue = std::atoi(value.c_str());
+    } else {
+      std::cerr << "Unknown option " << option << std::endl;
+      return 2;
+    }
+  }
+
+  if ((options.mode != "sign" && options.mode != "verify") || options.keystore.empty() ||
+      options.input.empty() || options.output.empty() || options.queue == 0) {
+    std::cerr << "Usage: abs-batch sign|verify --keystore file --input in --output out [--lines]"
+              << " [--attributes a,b] [--queue 64] [--slab] [--huge-pages]" << std::endl;
+    return 2;
+  }
+  if (options.attributes.empty()) {
+    options.attributes.assign(std::begin(attributesList), std::end(attributesList));
+  }
+
+  KeyStoreHeader header;
+  if (!ReadKeyStoreHeader(options.keystore, &header)) {
+    std::cerr << "Cannot read the key store " << options.keystore << std::endl;
+    return 1;
+  }
+
+  Streams streams;
+  if (!streams.open(options)) {
+    std::cerr << "Cannot open " << options.input << " or " << options.output << std::endl;
+    return 1;
+  }
+
+  try {
+    return header.numTowers > 1 ? run<DCRTPoly>(options, &streams) : run<NativePoly>(options, &streams);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+}
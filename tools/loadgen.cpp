@@ -0,0 +1,314 @@
+// Load generator for abs-verifierd. It signs a set of messages with the sign
+// key of a key store, replays them over several connections with a bounded
+// number of requests in flight, checks every answer and reports the
+// throughput and latency seen by the clients, followed by the daemon stats.
+//
+// Usage: abs-loadgen --keystore file --socket path [--create ringsize]
+//                    [--connections 4] [--requests 2000] [--window 16]
+//                    [--sets 3] [--signatures 16] [--invalid 10]
+//
+// --create first writes a new NativePoly key store with a sign key, which the
+// daemon can then be started with. --invalid is the percentage of requests
+// sent with an altered message, which must be answered as invalid. Exits with
+// status 1 if any answer is not the expected one; overloaded answers are only
+// counted.
+
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "keystore.h"
+#include "verifierprotocol.h"
+
+using namespace lbcrypto;
+
+typedef std::chrono::steady_clock Clock;
+
+struct LoadOptions {
+  string keystore;
+  string socket;
+  usint create = 0;
+  usint connections = 4;
+  usint requests = 2000;
+  usint window = 16;
+  usint sets = 3;
+  usint signatures = 16;
+  usint invalid = 10;
+};
+
+// Signed message ready to be sent
+struct Sample {
+  vector<uint8_t> signature;
+  string message;
+};
+
+// Outcome of the requests of one connection
+struct ConnectionResult {
+  vector<double> latencies;
+  uint64_t counts[VERIFIER_OVERLOADED + 1] = {0, 0, 0, 0};
+  uint64_t unexpected = 0;
+  bool failed = false;
+};
+
+static int connectTo(const string &path) {
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd >= 0 && connect(fd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// Signs options.signatures messages for each attribute set
+template <class Element>
+static vector<Sample> makeSamples(const LoadOptions &options) {
+  KeyStore<Element> store(options.keystore);
+  SignatureContext<Element> context;
+  context.GenerateGPVContext(store);
+
+  GPVVerificationKey<Element> vk;
+  GPVSignKey<Element> sk;
+  store.LoadVerificationKey(&vk);
+  store.LoadSignKey(&sk);
+
+  usint numAttributes = std::end(attributesList) - std::begin(attributesList);
+  vector<Sample> samples;
+  for (usint s = 0; s < options.sets; s++) {
+    vector<string> attributes(attributesList, attributesList + 1 + s % numAttributes);
+    auto ak = context.Extract(sk, vk, attributes);
+
+    for (usint i = 0; i < options.signatures; i++) {
+      Sample sample;
+      sample.message = "set " + std::to_string(s) + " message " + std::to_string(i);
+      sample.signature = context.SerializeSignature(context.Sign(vk, ak, attributes, sample.message));
+      samples.push_back(std::move(sample));
+    }
+  }
+  return samples;
+}
+
+// Sends requests from one thread and reads the answers from another, keeping
+// at most options.window requests in flight
+static void runConnection(const LoadOptions &options, const vector<Sample> &samples, usint index,
+                          usint requests, ConnectionResult *result) {
+  int fd = connectTo(options.socket);
+  if (fd < 0) {
+    result->failed = true;
+    return;
+  }
+
+  std::mutex lock;
+  std::condition_variable room;
+  usint inFlight = 0;
+  vector<Clock::time_point> sent(requests);
+  vector<VerifierStatus> expected(requests);
+
+  std::thread sender([&] {
+    std::mt19937 random(index);
+    for (usint i = 0; i < requests; i++) {
+      const Sample &sample = samples[(index + i) % samples.size()];
+      bool altered = random() % 100 < options.invalid;
+
+      vector<uint8_t> frame;
+      appendVerifyRequest(i, sample.signature, altered ? sample.message + "!" : sample.message, &frame);
+
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        room.wait(guard, [&] { return inFlight < options.window; });
+        inFlight++;
+        sent[i] = Clock::now();
+        expected[i] = altered ? VERIFIER_INVALID : VERIFIER_VALID;
+      }
+      if (!writeVerifierFrames(fd, frame)) return;
+    }
+  });
+
+  VerifierFrameReader reader(fd);
+  usint answered = 0;
+  try {
+    while (answered < requests && reader.fill()) {
+      const uint8_t *payload;
+      size_t size;
+      while (reader.next(&payload, &size)) {
+        VerifierResponse response;
+        parseVerifierResponse(payload, size, &response);
+        if (response.id >= requests) {
+          result->failed = true;
+          continue;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        result->latencies.push_back(
+            std::chrono::duration<double, std::micro>(Clock::now() - sent[response.id]).count());
+        result->counts[response.status]++;
+        if (response.status != expected[response.id] && response.status != VERIFIER_OVERLOADED)
+          result->unexpected++;
+        inFlight--;
+        answered++;
+        room.notify_one();
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Connection " << index << ": " << e.what() << std::endl;
+  }
+
+  if (answered < requests) result->failed = true;
+  // Unblock the sender if the daemon went away
+  shutdown(fd, SHUT_RDWR);
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    inFlight = 0;
+  }
+  room.notify_all();
+  sender.join();
+  close(fd);
+}
+
+// Asks the daemon for its statistics
+static string daemonStats(const string &path) {
+  int fd = connectTo(path);
+  if (fd < 0) return "{}";
+
+  vector<uint8_t> frame;
+  appendStatsRequest(0, &frame);
+  string stats = "{}";
+  try {
+    VerifierFrameReader reader(fd);
+    const uint8_t *payload;
+    size_t size;
+    while (writeVerifierFrames(fd, frame) && reader.fill()) {
+      frame.clear();
+      if (reader.next(&payload, &size)) {
+        VerifierResponse response;
+        parseVerifierResponse(payload, size, &response);
+        stats = response.stats;
+        break;
+      }
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+  }
+  close(fd);
+  return stats;
+}
+
+static double percentile(const vector<double> &sorted, double fraction) {
+  if (sorted.empty()) return 0;
+  size_t index = std::min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+  return sorted[index];
+}
+
+int main(int argc, char *argv[]) {
+  LoadOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    string option = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << option << std::endl;
+      return 2;
+    }
+
+    string value = argv[++i];
+    if (option == "--keystore") {
+      options.keystore = value;
+    } else if (option == "--socket") {
+      options.socket = value;
+    } else if (option == "--create") {
+      options.create = std::atoi(value.c_str());
+    } else if (option == "--connections") {
+      options.connections = std::atoi(value.c_str());
+    } else if (option == "--requests") {
+      options.requests = std::atoi(value.c_str());
+    } else if (option == "--window") {
+      options.window = std::atoi(value.c_str());
+    } else if (option == "--sets") {
+      options.sets = std::atoi(value.c_str());
+    } else if (option == "--signatures") {
+      options.signatures = std::atoi(value.c_str());
+    } else if (option == "--invalid") {
+      options.invalid = std::atoi(value.c_str());
+    } else {
+      std::cerr << "Unknown option " << option << std::endl;
+      return 2;
+    }
+  }
+
+  if (options.keystore.empty() || (options.socket.empty() && options.create == 0) ||
+      options.connections == 0 || options.window == 0 || options.sets == 0 || options.signatures == 0) {
+    std::cerr << "A key store, a socket path, connections, window, sets and signatures are needed" << std::endl;
+    return 2;
+  }
+
+  if (options.create > 0) {
+    SignatureContext<NativePoly> context;
+    context.GenerateGPVContext(options.create);
+    GPVVerificationKey<NativePoly> vk;
+    GPVSignKey<NativePoly> sk;
+    context.KeyGen(&sk, &vk);
+    context.SaveKeyStore(options.keystore, vk, &sk);
+    std::cerr << "Wrote " << options.keystore << std::endl;
+    if (options.socket.empty()) return 0;
+  }
+
+  KeyStoreHeader header;
+  if (!ReadKeyStoreHeader(options.keystore, &header)) {
+    std::cerr << "Cannot read the key store " << options.keystore << std::endl;
+    return 1;
+  }
+  vector<Sample> samples = header.numTowers > 1 ? makeSamples<DCRTPoly>(options)
+                                                : makeSamples<NativePoly>(options);
+
+  vector<ConnectionResult> results(options.connections);
+  vector<std::thread> connections;
+  usint perConnection = options.requests / options.connections;
+
+  auto start = Clock::now();
+  for (usint c = 0; c < options.connections; c++) {
+    connections.emplace_back(runConnection, std::cref(options), std::cref(samples), c, perConnection,
+                             &results[c]);
+  }
+  for (auto &connection : connections) connection.join();
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  vector<double> latencies;
+  uint64_t counts[VERIFIER_OVERLOADED + 1] = {0, 0, 0, 0};
+  uint64_t unexpected = 0;
+  bool failed = false;
+  for (const auto &result : results) {
+    latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+    for (int s = 0; s <= VERIFIER_OVERLOADED; s++) counts[s] += result.counts[s];
+    unexpected += result.unexpected;
+    failed = failed || result.failed;
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  std::cout << std::fixed << std::setprecision(1)
+            << "requests " << latencies.size() << " in " << seconds << " s, "
+            << latencies.size() / seconds << " req/s" << std::endl
+            << "latency us p50 " << percentile(latencies, 0.5) << " p90 " << percentile(latencies, 0.9)
+            << " p99 " << percentile(latencies, 0.99) << " max " << (latencies.empty() ? 0 : latencies.back())
+            << std::endl
+            << "valid " << counts[VERIFIER_VALID] << " invalid " << counts[VERIFIER_INVALID]
+            << " malformed " << counts[VERIFIER_MALFORMED] << " overloaded " << counts[VERIFIER_OVERLOADED]
+            << " unexpected " << unexpected << std::endl
+            << "daemon " << daemonStats(options.socket) << std::endl;
+
+  if (failed) std::cerr << "Some connections did not get every answer" << std::endl;
+  return failed || unexpected > 0 ? 1 : 0;
+}
@@ -0,0 +1,439 @@
+// Verification daemon: loads the parameters and verification key of a key
+// store once and verifies signatures for local clients over a Unix domain
+// socket, using the framing of verifierprotocol.h.
+//
+// Usage: abs-verifierd --keystore file --socket path [--threads N]
+//                      [--queue 1024] [--batch 32] [--window 4]
+//                      [--reject-when-full] [--report seconds]
+//
+// Each connection has a reader thread. The requests it finds in the bytes of
+// a single read are grouped by attribute set, and each group (up to --batch
+// requests) is verified as one VerifyBatch task, so the syndromes of a set
+// are computed once per group. The tasks run on a work stealing pool holding
+// at most --queue waiting tasks. When it is full the readers stop reading,
+// which fills the socket buffers and blocks the clients, or with
+// --reject-when-full the requests are answered as overloaded at once.
+//
+// A STATS request returns the queue depth, the request counters, the latency
+// percentiles from the reception of a request to its response, and the phase
+// timings of absstats.h. --report prints the same JSON to stderr periodically.
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include "signaturecontext.h"
+#include "abs.h"
+#include "abswire.h"
+#include "absstats.h"
+#include "keystore.h"
+#include "verifierprotocol.h"
+#include "workstealingpool.h"
+
+using namespace lbcrypto;
+
+typedef std::chrono::steady_clock Clock;
+
+struct DaemonOptions {
+  string keystore;
+  string socket;
+  usint threads = 0;
+  size_t queue = 1024;
+  size_t batch = 32;
+  usint window = 4;
+  bool rejectWhenFull = false;
+  double report = 0;
+};
+
+static std::atomic<bool> stopping(false);
+
+static void onSignal(int) { stopping = true; }
+
+// Client connection, closed once the reader and every task answering its
+// requests are done with it
+struct Connection {
+  explicit Connection(int fd) : fd(fd) {}
+  ~Connection() { close(fd); }
+
+  // Responses of different tasks are written whole, one after the other
+  void send(const vector<uint8_t> &frames) {
+    std::lock_guard<std::mutex> guard(writeLock);
+    writeVerifierFrames(fd, frames);
+  }
+
+  int fd;
+  std::mutex writeLock;
+};
+
+// Verify request waiting for its batch. The request and the signature view
+// point into the payload
+struct PendingRequest {
+  vector<uint8_t> payload;
+  VerifierRequest request;
+  SignatureWireView view;
+  Clock::time_point received;
+};
+
+typedef vector<shared_ptr<PendingRequest>> RequestBatch;
+
+// Order independent key of the attribute set and hash mode of a signature
+static string attributeSetKey(const SignatureWireView &view) {
+  vector<string> attributes;
+  for (const auto &attribute : view.attributes) {
+    attributes.emplace_back(attribute.first, attribute.second);
+  }
+  std::sort(attributes.begin(), attributes.end());
+
+  string key(1, static_cast<char>(view.hashMode));
+  for (const string &attribute : attributes) {
+    key.append(std::to_string(attribute.size()));
+    key.push_back(':');
+    key.append(attribute);
+  }
+  return key;
+}
+
+template <class Element>
+class VerifierDaemon {
+ public:
+  VerifierDaemon(const DaemonOptions &options, const KeyStore<Element> &store)
+      : options(options), pool(poolConfig(options)) {
+    context.GenerateGPVContext(store);
+    store.LoadVerificationKey(&vk);
+    params = std::static_pointer_cast<GPVSignatureParameters<Element>>(context.GetParams());
+
+    // The pool already runs a batch per core
+    context.SetBatchThreads(1);
+    if (options.window > 0) context.SetSubsetSumWindow(options.window);
+
+    memset(&latency, 0, sizeof(latency));
+  }
+
+  // Accepts connections until a signal arrives, then closes them and waits
+  // for their readers
+  void serve(int listenFd) {
+    Clock::time_point nextReport = Clock::now();
+
+    while (!stopping) {
+      if (options.report > 0 && Clock::now() >= nextReport) {
+        std::cerr << statsJson() << std::endl;
+        nextReport = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+                                        std::chrono::duration<double>(options.report));
+      }
+
+      struct pollfd ready = {listenFd, POLLIN, 0};
+      if (poll(&ready, 1, 200) <= 0) continue;
+
+      int fd = accept(listenFd, nullptr, nullptr);
+      if (fd < 0) continue;
+
+      auto connection = std::make_shared<Connection>(fd);
+      {
+        std::lock_guard<std::mutex> guard(connectionsLock);
+        openConnections.insert(fd);
+        activeReaders++;
+        connections++;
+      }
+      std::thread(&VerifierDaemon::handleConnection, this, connection).detach();
+    }
+
+    // Wake the readers up, the tasks still queued answer into closed sockets
+    std::unique_lock<std::mutex> lock(connectionsLock);
+    for (int fd : openConnections) shutdown(fd, SHUT_RDWR);
+    readersDone.wait(lock, [this] { return activeReaders == 0; });
+  }
+
+  string statsJson() {
+    WorkStealingPoolStats poolStats = pool.GetStats();
+    std::lock_guard<std::mutex> guard(statsLock);
+
+    std::ostringstream out;
+    out << "{\"workers\": " << pool.GetWorkers() << ", \"capacity\": " << pool.GetCapacity()
+        << ", \"queue_depth\": " << poolStats.pending << ", \"max_queue_depth\": " << poolStats.maxPending
+        << ", \"stolen\": " << poolStats.stolen << ", \"waits\": " << poolStats.waits
+        << ", \"connections\": " << connections << ", \"requests\": " << latency.calls
+        << ", \"valid\": " << valid << ", \"invalid\": " << invalid << ", \"malformed\": " << malformed
+        << ", \"overloaded\": " << overloaded << ", \"batches\": " << batches
+        << ", \"mean_batch\": " << (batches ? double(batched) / batches : 0.0)
+        << ", \"latency_ns\": {\"mean\": " << (latency.calls ? latency.totalNs / latency.calls : 0)
+        << ", \"p50\": " << absStatsPercentile(latency, 0.5) << ", \"p90\": " << absStatsPercentile(latency, 0.9)
+        << ", \"p99\": " << absStatsPercentile(latency, 0.99) << ", \"max\": " << latency.maxNs
+        << "}, \"timings\": " << absStatsJson(absStatsSnapshot()) << "}";
+    return out.str();
+  }
+
+ private:
+  static WorkStealingPoolConfig poolConfig(const DaemonOptions &options) {
+    WorkStealingPoolConfig config;
+    config.workers = options.threads;
+    config.capacity = options.queue;
+    return config;
+  }
+
+  // Reads requests until the client leaves, answering the stats and the
+  // malformed ones at once and queuing the others by attribute set
+  void handleConnection(shared_ptr<Connection> connection) {
+    VerifierFrameReader reader(connection->fd);
+
+    try {
+      while (!stopping && reader.fill()) {
+        std::map<string, RequestBatch> groups;
+        vector<uint8_t> answers;
+        const uint8_t *payload;
+        size_t size;
+
+        while (reader.next(&payload, &size)) {
+          auto pending = std::make_shared<PendingRequest>();
+          pending->received = Clock::now();
+          pending->payload.assign(payload, payload + size);
+
+          // A bad frame header means the stream is out of sync, which
+          // closes the connection
+          VerifierRequest &request = pending->request;
+          parseVerifierRequest(pending->payload.data(), size, &request);
+
+          if (request.type == VERIFIER_STATS) {
+            appendStatsResponse(request.id, statsJson(), &answers);
+            continue;
+          }
+
+          try {
+            parseSignature<Element>(params, request.signature, request.signatureSize, &pending->view);
+          } catch (const std::exception &) {
+            appendVerifyResponse(request.id, VERIFIER_MALFORMED, &answers);
+            record(VERIFIER_MALFORMED, pending->received);
+            continue;
+          }
+
+          RequestBatch &group = groups[attributeSetKey(pending->view)];
+          group.push_back(pending);
+          if (group.size() >= options.batch) {
+            dispatch(connection, std::move(group));
+            group.clear();
+          }
+        }
+
+        if (!answers.empty()) connection->send(answers);
+        for (auto &group : groups) {
+          if (!group.second.empty()) dispatch(connection, std::move(group.second));
+        }
+      }
+    } catch (const std::exception &e) {
+      std::cerr << "Closing connection: " << e.what() << std::endl;
+    }
+
+    std::lock_guard<std::mutex> guard(connectionsLock);
+    openConnections.erase(connection->fd);
+    if (--activeReaders == 0) readersDone.notify_all();
+  }
+
+  // Queues a batch, waiting for room or answering it as overloaded
+  void dispatch(const shared_ptr<Connection> &connection, RequestBatch batch) {
+    auto task = [this, connection, batch] { verify(*connection, batch); };
+
+    if (!options.rejectWhenFull) {
+      pool.Submit(task);
+      return;
+    }
+    if (pool.TrySubmit(task)) return;
+
+    vector<uint8_t> answers;
+    for (const auto &pending : batch) {
+      appendVerifyResponse(pending->request.id, VERIFIER_OVERLOADED, &answers);
+    }
+    connection->send(answers);
+    for (const auto &pending : batch) record(VERIFIER_OVERLOADED, pending->received);
+  }
+
+  // Verifies the signatures of a batch, all of the same attribute set
+  void verify(Connection &connection, const RequestBatch &batch) {
+    vector<std::pair<signatureABS<Element>, string>> items;
+    vector<VerifierStatus> statuses(batch.size(), VERIFIER_MALFORMED);
+    vector<size_t> itemRequest;
+
+    for (size_t i = 0; i < batch.size(); i++) {
+      const VerifierRequest &request = batch[i]->request;
+      try {
+        items.emplace_back(decodeSignature<Element>(params, batch[i]->view),
+                           string(reinterpret_cast<const char *>(request.message), request.messageSize));
+        itemRequest.push_back(i);
+      } catch (const std::exception &) {
+      }
+    }
+
+    try {
+      vector<bool> results = context.VerifyBatch(vk, items);
+      for (size_t j = 0; j < results.size(); j++) {
+        statuses[itemRequest[j]] = results[j] ? VERIFIER_VALID : VERIFIER_INVALID;
+      }
+    } catch (const std::exception &) {
+      // Signatures that do not fit the ring stay malformed
+    }
+
+    vector<uint8_t> answers;
+    for (size_t i = 0; i < batch.size(); i++) {
+      appendVerifyResponse(batch[i]->request.id, statuses[i], &answers);
+    }
+    connection.send(answers);
+
+    std::lock_guard<std::mutex> guard(statsLock);
+    batches++;
+    batched += batch.size();
+    Clock::time_point now = Clock::now();
+    for (size_t i = 0; i < batch.size(); i++) {
+      countStatus(statuses[i]);
+      absStatsAdd(&latency, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                now - batch[i]->received).count());
+    }
+  }
+
+  void record(VerifierStatus status, Clock::time_point received) {
+    std::lock_guard<std::mutex> guard(statsLock);
+    countStatus(status);
+    absStatsAdd(&latency, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              Clock::now() - received).count());
+  }
+
+  // statsLock must be held
+  void countStatus(VerifierStatus status) {
+    switch (status) {
+      case VERIFIER_VALID: valid++; break;
+      case VERIFIER_INVALID: invalid++; break;
+      case VERIFIER_MALFORMED: malformed++; break;
+      case VERIFIER_OVERLOADED: overloaded++; break;
+    }
+  }
+
+  DaemonOptions options;
+  SignatureContext<Element> context;
+  GPVVerificationKey<Element> vk;
+  shared_ptr<GPVSignatureParameters<Element>> params;
+
+  std::mutex connectionsLock;
+  std::condition_variable readersDone;
+  std::set<int> openConnections;
+  size_t activeReaders = 0;
+
+  // Counters of the answered requests, latency.calls being their total
+  std::mutex statsLock;
+  uint64_t connections = 0;
+  uint64_t valid = 0;
+  uint64_t invalid = 0;
+  uint64_t malformed = 0;
+  uint64_t overloaded = 0;
+  uint64_t batches = 0;
+  uint64_t batched = 0;
+  ABSPhaseStats latency;
+
+  // Last member, so the queued tasks run before the rest is destroyed
+  WorkStealingPool pool;
+};
+
+template <class Element>
+static void run(const DaemonOptions &options, int listenFd) {
+  KeyStore<Element> store(options.keystore);
+  VerifierDaemon<Element> daemon(options, store);
+
+  std::cerr << "Verifying on " << options.socket << std::endl;
+  daemon.serve(listenFd);
+  std::cerr << daemon.statsJson() << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  DaemonOptions options;
+
+  for (int i = 1; i < argc; i++) {
+    string option = argv[i];
+    if (option == "--reject-when-full") {
+      options.rejectWhenFull = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << option << std::endl;
+      return 2;
+    }
+
+    string value = argv[++i];
+    if (option == "--keystore") {
+      options.keystore = value;
+    } else if (option == "--socket") {
+      options.socket = value;
+    } else if (option == "--threads") {
+      options.threads = std::atoi(value.c_str());
+    } else if (option == "--queue") {
+      options.queue = std::atoi(value.c_str());
+    } else if (option == "--batch") {
+      options.batch = std::atoi(value.c_str());
+    } else if (option == "--window") {
+      options.window = std::atoi(value.c_str());
+    } else if (option == "--report") {
+      options.report = std::atof(value.c_str());
+    } else {
+      std::cerr << "Unknown option " << option << std::endl;
+      return 2;
+    }
+  }
+
+  if (options.keystore.empty() || options.socket.empty() || options.batch == 0) {
+    std::cerr << "A key store, a socket path and a batch size are needed" << std::endl;
+    return 2;
+  }
+
+  KeyStoreHeader header;
+  if (!ReadKeyStoreHeader(options.keystore, &header)) {
+    std::cerr << "Cannot read the key store " << options.keystore << std::endl;
+    return 1;
+  }
+
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (options.socket.size() >= sizeof(address.sun_path)) {
+    std::cerr << "Socket path too long" << std::endl;
+    return 2;
+  }
+  strncpy(address.sun_path, options.socket.c_str(), sizeof(address.sun_path) - 1);
+
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  unlink(options.socket.c_str());
+  if (listenFd < 0 || bind(listenFd, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0 ||
+      listen(listenFd, SOMAXCONN) < 0) {
+    std::cerr << "Cannot listen on " << options.socket << ": " << strerror(errno) << std::endl;
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+
+  int status = 0;
+  try {
+    if (header.numTowers > 1) {
+      run<DCRTPoly>(options, listenFd);
+    } else {
+      run<NativePoly>(options, listenFd);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    status = 1;
+  }
+
+  close(listenFd);
+  unlink(options.socket.c_str());
+  return status;
+}